@@ -0,0 +1,108 @@
+/**
+ * bench_allocation.cpp
+ * part of pdinklag/lz77
+ * 
+ * MIT License
+ * 
+ * Copyright (c) Patrick Dinklage
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <lz77/kkp2_factorizer.hpp>
+#include <lz77/lpf_factorizer.hpp>
+
+// compares the running times of the suffix array based factorizers under different allocation policies
+// usage: bench-allocation [file] [n]
+// if no file is given, a random text of length n (default: 64 MiB) with long repetitions is generated
+
+using namespace lz77;
+
+std::string generate(size_t const n) {
+    std::mt19937_64 gen(147);
+    std::string s;
+    s.reserve(n);
+    while(s.size() < n) {
+        if(s.size() > 1024 && gen() % 2) {
+            // copy a random earlier substring
+            size_t const src = gen() % (s.size() - 1024);
+            size_t const len = std::min(size_t(1 + gen() % 1024), n - s.size());
+            for(size_t i = 0; i < len; i++) s.push_back(s[src + i]);
+        } else {
+            s.push_back('a' + gen() % 16);
+        }
+    }
+    return s;
+}
+
+template<typename Factorizer>
+void bench(std::string const& algo, std::string const& text, std::string const& policy_name, AllocationPolicy const& policy) {
+    Factorizer factorizer;
+    factorizer.allocation_policy(policy);
+
+    size_t z = 0;
+    auto count = [&](Factor){ ++z; };
+
+    auto const t0 = std::chrono::steady_clock::now();
+    factorizer.factorize(text.begin(), text.end(), count, count);
+    auto const t1 = std::chrono::steady_clock::now();
+
+    auto const& report = factorizer.report();
+    std::cout << "RESULT algo=" << algo << " policy=" << policy_name << " n=" << text.size() << " z=" << z
+        << " time=" << std::chrono::duration_cast<std::chrono::milliseconds>(t1 - t0).count()
+        << " sa=" << report.suffix_array.nanoseconds / 1000000
+        << " inverse=" << report.inverse.nanoseconds / 1000000
+        << " factorization=" << report.factorization.nanoseconds / 1000000
+        << " threads=" << report.num_threads << std::endl;
+}
+
+int main(int argc, char** argv) {
+    std::string text;
+    if(argc > 1) {
+        std::ifstream f(argv[1], std::ios::binary);
+        text.assign(std::istreambuf_iterator<char>(f), std::istreambuf_iterator<char>());
+    } else {
+        text = generate(64ULL << 20);
+    }
+    if(argc > 2) text.resize(std::min(text.size(), (size_t)std::strtoull(argv[2], nullptr, 10)));
+
+    using HugePages = AllocationPolicy::HugePages;
+    std::vector<std::pair<std::string, AllocationPolicy>> const policies = {
+        {"default", {}},
+        {"thp", {HugePages::transparent, false, false}},
+        {"hugetlb", {HugePages::hugetlb, false, false}},
+        {"interleave", {HugePages::none, true, false}},
+        {"first-touch", {HugePages::none, false, true}},
+        {"thp+interleave", {HugePages::transparent, true, false}},
+        {"thp+first-touch", {HugePages::transparent, false, true}},
+    };
+
+    for(auto const& [name, policy] : policies) bench<KKP2Factorizer>("kkp2", text, name, policy);
+    for(auto const& [name, policy] : policies) bench<LPFFactorizer>("lpf", text, name, policy);
+    return 0;
+}
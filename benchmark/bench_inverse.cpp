@@ -0,0 +1,64 @@
+/**
+ * bench_inverse.cpp
+ * part of pdinklag/lz77
+ * 
+ * MIT License
+ * 
+ * Copyright (c) Patrick Dinklage
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <numeric>
+#include <random>
+#include <vector>
+
+#include <lz77/inverse_suffix_array.hpp>
+
+// compares the naive suffix array inversion against the partitioned kernel on a random permutation
+// usage: bench-inverse [n]
+// the default n is 2^28
+
+using namespace lz77;
+
+int main(int argc, char** argv) {
+    size_t const n = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : (1ULL << 28);
+
+    std::vector<uint32_t> sa(n), isa(n);
+    std::iota(sa.begin(), sa.end(), 0);
+    std::shuffle(sa.begin(), sa.end(), std::mt19937(147));
+
+    for(size_t rep = 0; rep < 3; rep++) {
+        auto const t0 = std::chrono::steady_clock::now();
+        for(size_t i = 0; i < n; i++) isa[sa[i]] = i;
+        auto const t1 = std::chrono::steady_clock::now();
+
+        Report report;
+        inverse_suffix_array<uint32_t>(sa.data(), isa.data(), n, report);
+        auto const t2 = std::chrono::steady_clock::now();
+
+        std::cout << "RESULT n=" << n
+            << " naive=" << std::chrono::duration_cast<std::chrono::milliseconds>(t1 - t0).count()
+            << " partitioned=" << std::chrono::duration_cast<std::chrono::milliseconds>(t2 - t1).count() << std::endl;
+    }
+    return 0;
+}
@@ -0,0 +1,207 @@
+/**
+ * lz77/allocation.hpp
+ * part of pdinklag/lz77
+ * 
+ * MIT License
+ * 
+ * Copyright (c) Patrick Dinklage
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef _LZ77_ALLOCATION_HPP
+#define _LZ77_ALLOCATION_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+
+#ifdef __linux__
+#include <linux/mempolicy.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace lz77 {
+
+/**
+ * \brief Describes how the large arrays of the suffix array based factorizers are allocated
+ * 
+ * Arrays like the suffix array and its inverse are accessed randomly, so TLB misses and accesses to remote NUMA nodes
+ * can dominate the running time on large inputs. Huge pages reduce the former, and interleaving or first-touch placement
+ * spread the arrays across the NUMA nodes used by the OpenMP team.
+ * 
+ * All options except \ref HugePages::none are only available on Linux and are silently ignored elsewhere or if the system does not support them.
+ */
+struct AllocationPolicy {
+    /**
+     * \brief The kind of huge pages to request
+     */
+    enum class HugePages {
+        /**
+         * \brief Use regular allocation
+         */
+        none,
+
+        /**
+         * \brief Request transparent huge pages via \c madvise
+         */
+        transparent,
+
+        /**
+         * \brief Request explicit huge pages via \c MAP_HUGETLB , falling back to transparent huge pages if none are available
+         */
+        hugetlb
+    };
+
+    /**
+     * \brief The kind of huge pages to request
+     */
+    HugePages huge_pages = HugePages::none;
+
+    /**
+     * \brief Whether to interleave pages across all NUMA nodes
+     */
+    bool interleave = false;
+
+    /**
+     * \brief Whether to touch pages first using a static OpenMP schedule
+     * 
+     * This places each page on the NUMA node of the thread that processes the corresponding part of the array in a
+     * statically scheduled parallel loop. This has no effect if interleaving is enabled.
+     */
+    bool first_touch = false;
+};
+
+/**
+ * \brief Frees arrays allocated by \ref allocate
+ */
+class BufferDeleter {
+private:
+    size_t bytes_;
+
+public:
+    BufferDeleter() : bytes_(0) {}
+    BufferDeleter(size_t const bytes) : bytes_(bytes) {}
+
+    template<typename T>
+    void operator()(T* p) const {
+        #ifdef __linux__
+        if(bytes_) {
+            munmap((void*)p, bytes_);
+            return;
+        }
+        #endif
+        delete[] p;
+    }
+};
+
+/**
+ * \brief An array allocated by \ref allocate
+ */
+template<typename T>
+using Buffer = std::unique_ptr<T[], BufferDeleter>;
+
+/**
+ * \brief Allocates a zero-initialized array according to an allocation policy
+ * 
+ * \tparam T the array entry type
+ * \param n the number of entries
+ * \param policy the allocation policy
+ * \return the array
+ */
+template<typename T>
+Buffer<T> allocate(size_t const n, AllocationPolicy const& policy) {
+    #ifdef __linux__
+    if(n > 0 && (policy.huge_pages != AllocationPolicy::HugePages::none || policy.interleave || policy.first_touch)) {
+        constexpr size_t HUGE_PAGE_SIZE = 1ULL << 21;
+        bool const huge = policy.huge_pages != AllocationPolicy::HugePages::none;
+        size_t const page = huge ? HUGE_PAGE_SIZE : (size_t)sysconf(_SC_PAGESIZE);
+        size_t const bytes = ((n * sizeof(T) + page - 1) / page) * page;
+
+        void* p = MAP_FAILED;
+        if(policy.huge_pages == AllocationPolicy::HugePages::hugetlb) {
+            p = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        }
+
+        if(p == MAP_FAILED) {
+            if(huge) {
+                // over-allocate and trim so that the array is aligned to huge pages, as required for transparent huge pages
+                auto* q = (uint8_t*)mmap(nullptr, bytes + HUGE_PAGE_SIZE, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+                if((void*)q == MAP_FAILED) throw std::bad_alloc();
+
+                size_t const head = (HUGE_PAGE_SIZE - (uintptr_t)q % HUGE_PAGE_SIZE) % HUGE_PAGE_SIZE;
+                if(head) munmap(q, head);
+                if(HUGE_PAGE_SIZE - head) munmap(q + head + bytes, HUGE_PAGE_SIZE - head);
+                p = q + head;
+
+                madvise(p, bytes, MADV_HUGEPAGE);
+            } else {
+                p = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+                if(p == MAP_FAILED) throw std::bad_alloc();
+            }
+        }
+
+        if(policy.interleave) {
+            // interleave across all nodes allowed for this process; the kernel ignores nodes that are not available
+            unsigned long nodes = ~0UL;
+            syscall(SYS_mbind, p, bytes, MPOL_INTERLEAVE, &nodes, sizeof(nodes) * 8, 0);
+        } else if(policy.first_touch) {
+            auto* q = (uint8_t*)p;
+            ssize_t const num_pages = bytes / page;
+
+            #ifdef LIBSAIS_OPENMP
+            #pragma omp parallel for schedule(static)
+            #endif
+            for(ssize_t i = 0; i < num_pages; i++) q[i * page] = 0;
+        }
+        return Buffer<T>((T*)p, BufferDeleter(bytes));
+    }
+    #endif
+
+    return Buffer<T>(new T[n](), BufferDeleter());
+}
+
+/**
+ * \brief Allocates an array according to an allocation policy without initializing it
+ * 
+ * This avoids the cost of initialization for arrays that are entirely overwritten anyway.
+ * 
+ * \tparam T the array entry type
+ * \param n the number of entries
+ * \param policy the allocation policy
+ * \return the array
+ */
+template<typename T>
+Buffer<T> allocate_for_overwrite(size_t const n, AllocationPolicy const& policy) {
+    #ifdef __linux__
+    if(policy.huge_pages != AllocationPolicy::HugePages::none || policy.interleave || policy.first_touch) {
+        // mapped pages are not initialized explicitly
+        return allocate<T>(n, policy);
+    }
+    #endif
+
+    return Buffer<T>(new T[n], BufferDeleter());
+}
+
+}
+
+#endif
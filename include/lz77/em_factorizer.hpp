@@ -0,0 +1,635 @@
+/**
+ * lz77/em_factorizer.hpp
+ * part of pdinklag/lz77
+ * 
+ * MIT License
+ * 
+ * Copyright (c) Patrick Dinklage
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef _LZ77_EM_FACTORIZER_HPP
+#define _LZ77_EM_FACTORIZER_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <iterator>
+#include <memory>
+#include <queue>
+#include <string>
+#include <system_error>
+#include <vector>
+
+#include <unistd.h>
+
+#include "emit_function.hpp"
+#include "report.hpp"
+
+namespace lz77 {
+
+/**
+ * \brief Computes an exact Lempel-Ziv 77 factorization of a file in external memory
+ * 
+ * The input file is never held in RAM. The suffix array is constructed by prefix doubling using external sorting,
+ * the previous and next smaller values of the suffix array are computed in a single scan using an external stack,
+ * and the longest common extensions of the phrase starts are finally computed by reading the input file.
+ * All intermediate data is kept in files in a scratch directory, and the RAM used for sorting and buffering
+ * is bounded (approximately) by a user-configured budget.
+ * 
+ * The previous and next smaller values are exactly those used by \ref KKP2Factorizer and ties are broken in the same way,
+ * i.e., the resulting factorization is identical to that of \ref KKP2Factorizer .
+ */
+class EMFactorizer {
+public:
+    /**
+     * \brief Describes the I/O volume generated by a factorization
+     */
+    struct IOVolume {
+        /**
+         * \brief The number of bytes read from the input and scratch files
+         */
+        uintmax_t bytes_read;
+
+        /**
+         * \brief The number of bytes written to scratch files
+         */
+        uintmax_t bytes_written;
+    };
+
+private:
+    static constexpr uint64_t NONE = UINT64_MAX;
+    static constexpr size_t MAX_BUFFER_BYTES = 1ULL << 20;
+    static constexpr size_t LCE_CHUNK = 256;
+
+    struct Name {
+        uint64_t pos;
+        uint64_t rank;
+    };
+
+    struct Tuple {
+        uint64_t rank1;
+        uint64_t rank2;
+        uint64_t pos;
+    };
+
+    struct StackEntry {
+        uint64_t pos;
+        uint64_t psv;
+    };
+
+    struct Candidates {
+        uint64_t pos;
+        uint64_t psv;
+        uint64_t nsv;
+    };
+
+    class File {
+    private:
+        std::FILE* f_;
+        IOVolume* io_;
+
+    public:
+        File(std::filesystem::path const& path, char const* mode, IOVolume& io) : io_(&io) {
+            f_ = std::fopen(path.c_str(), mode);
+            if(!f_) throw std::system_error(errno, std::generic_category(), path.string());
+        }
+
+        ~File() {
+            std::fclose(f_);
+        }
+
+        File(File const&) = delete;
+        File& operator=(File const&) = delete;
+
+        void seek(uintmax_t const offs) {
+            if(fseeko(f_, offs, SEEK_SET)) throw std::system_error(errno, std::generic_category(), "fseeko");
+        }
+
+        size_t read(void* buf, size_t const bytes) {
+            size_t const num = std::fread(buf, 1, bytes, f_);
+            io_->bytes_read += num;
+            return num;
+        }
+
+        void write(void const* buf, size_t const bytes) {
+            if(std::fwrite(buf, 1, bytes, f_) != bytes) throw std::system_error(errno, std::generic_category(), "fwrite");
+            io_->bytes_written += bytes;
+        }
+    };
+
+    // a file in the scratch directory that is removed on destruction
+    class ScratchFile {
+    private:
+        static inline std::atomic<uint64_t> counter_ = 0;
+
+        std::filesystem::path path_;
+
+    public:
+        ScratchFile(std::filesystem::path const& dir) {
+            path_ = dir / ("lz77-em-" + std::to_string(getpid()) + "-" + std::to_string(counter_++) + ".tmp");
+        }
+
+        ~ScratchFile() {
+            std::error_code ec;
+            std::filesystem::remove(path_, ec);
+        }
+
+        ScratchFile(ScratchFile const&) = delete;
+        ScratchFile& operator=(ScratchFile const&) = delete;
+
+        std::filesystem::path const& path() const { return path_; }
+    };
+
+    template<typename T>
+    class Writer {
+    private:
+        File file_;
+        Report* report_;
+        std::vector<T> buf_;
+        size_t capacity_;
+
+    public:
+        Writer(std::filesystem::path const& path, EMFactorizer& em, size_t const capacity)
+            : file_(path, "wb", em.io_), report_(&em.report_), capacity_(capacity) {
+            buf_.reserve(capacity_);
+            report_->allocate(capacity_ * sizeof(T));
+        }
+
+        ~Writer() {
+            flush();
+            report_->deallocate(capacity_ * sizeof(T));
+        }
+
+        void push(T const& x) {
+            buf_.push_back(x);
+            if(buf_.size() == capacity_) flush();
+        }
+
+        void flush() {
+            if(!buf_.empty()) {
+                file_.write(buf_.data(), buf_.size() * sizeof(T));
+                buf_.clear();
+            }
+        }
+    };
+
+    template<typename T>
+    class Reader {
+    private:
+        File file_;
+        Report* report_;
+        std::vector<T> buf_;
+        size_t pos_;
+        size_t avail_;
+        uintmax_t remaining_;
+
+        void fill() {
+            size_t const num = std::min(uintmax_t(buf_.size()), remaining_);
+            file_.read(buf_.data(), num * sizeof(T));
+            remaining_ -= num;
+            avail_ = num;
+            pos_ = 0;
+        }
+
+    public:
+        Reader(std::filesystem::path const& path, EMFactorizer& em, size_t const capacity, uintmax_t const first = 0)
+            : file_(path, "rb", em.io_), report_(&em.report_), buf_(capacity), pos_(0), avail_(0) {
+
+            uintmax_t const num = std::filesystem::file_size(path) / sizeof(T);
+            remaining_ = first < num ? num - first : 0;
+            if(first) file_.seek(first * sizeof(T));
+            report_->allocate(buf_.size() * sizeof(T));
+        }
+
+        ~Reader() {
+            report_->deallocate(buf_.size() * sizeof(T));
+        }
+
+        bool empty() const { return pos_ == avail_ && remaining_ == 0; }
+
+        T const& peek() {
+            if(pos_ == avail_) fill();
+            return buf_[pos_];
+        }
+
+        T next() {
+            T const x = peek();
+            ++pos_;
+            return x;
+        }
+    };
+
+    // a stack that keeps only its top part in RAM and spills the rest into a scratch file
+    template<typename T>
+    class Stack {
+    private:
+        ScratchFile scratch_;
+        File file_;
+        Report* report_;
+        std::vector<T> top_;
+        size_t page_;
+        uintmax_t spilled_;
+
+    public:
+        Stack(EMFactorizer& em, size_t const page)
+            : scratch_(em.scratch_dir_), file_(scratch_.path(), "w+b", em.io_), report_(&em.report_), page_(page), spilled_(0) {
+            top_.reserve(2 * page_);
+            report_->allocate(2 * page_ * sizeof(T));
+        }
+
+        ~Stack() {
+            report_->deallocate(2 * page_ * sizeof(T));
+        }
+
+        bool empty() const { return top_.empty() && spilled_ == 0; }
+
+        T const& top() {
+            if(top_.empty()) {
+                // load a page from disk
+                spilled_ -= page_;
+                top_.resize(page_);
+                file_.seek(spilled_ * sizeof(T));
+                file_.read(top_.data(), page_ * sizeof(T));
+            }
+            return top_.back();
+        }
+
+        void pop() {
+            top();
+            top_.pop_back();
+        }
+
+        void push(T const& x) {
+            if(top_.size() == 2 * page_) {
+                // spill the bottom page to disk
+                file_.seek(spilled_ * sizeof(T));
+                file_.write(top_.data(), page_ * sizeof(T));
+                spilled_ += page_;
+                top_.erase(top_.begin(), top_.begin() + page_);
+            }
+            top_.push_back(x);
+        }
+    };
+
+    size_t min_ref_len_;
+    size_t max_ref_len_;
+    size_t ram_budget_;
+    std::filesystem::path scratch_dir_;
+    IOVolume io_;
+    Report report_;
+
+    template<typename T>
+    size_t buffer_capacity() const {
+        return std::max(std::min(ram_budget_ / 16, MAX_BUFFER_BYTES) / sizeof(T), size_t(1));
+    }
+
+    // sorts the records in file in into file out using runs that fit into the RAM budget, followed by multiway merging
+    template<typename T, typename Less>
+    void sort(std::filesystem::path const& in, std::filesystem::path const& out, Less less) {
+        using Run = std::unique_ptr<ScratchFile>;
+
+        // form sorted runs
+        std::vector<Run> runs;
+        {
+            size_t const run_capacity = std::max((ram_budget_ / 4 * 3) / sizeof(T), size_t(2));
+
+            Reader<T> r(in, *this, buffer_capacity<T>());
+            std::vector<T> run;
+            run.reserve(run_capacity);
+            report_.allocate(run_capacity * sizeof(T));
+            while(!r.empty()) {
+                run.clear();
+                while(!r.empty() && run.size() < run_capacity) run.push_back(r.next());
+                std::sort(run.begin(), run.end(), less);
+
+                runs.emplace_back(std::make_unique<ScratchFile>(scratch_dir_));
+                Writer<T> w(runs.back()->path(), *this, buffer_capacity<T>());
+                for(auto const& x : run) w.push(x);
+            }
+            report_.deallocate(run_capacity * sizeof(T));
+        }
+
+        // merge runs until a single one is left
+        size_t const fan_in = std::max(ram_budget_ / (buffer_capacity<T>() * sizeof(T)), size_t(2));
+        auto merge = [&](Run* first, size_t const k, std::filesystem::path const& dest){
+            size_t const capacity = std::max(ram_budget_ / ((k + 1) * sizeof(T)), size_t(1));
+
+            std::vector<std::unique_ptr<Reader<T>>> readers;
+            readers.reserve(k);
+            for(size_t i = 0; i < k; i++) readers.emplace_back(std::make_unique<Reader<T>>(first[i]->path(), *this, capacity));
+
+            auto greater = [&](size_t const a, size_t const b){
+                auto const& x = readers[a]->peek();
+                auto const& y = readers[b]->peek();
+                return less(y, x) || (!less(x, y) && a > b);
+            };
+            std::priority_queue<size_t, std::vector<size_t>, decltype(greater)> pq(greater);
+            for(size_t i = 0; i < k; i++) if(!readers[i]->empty()) pq.push(i);
+
+            Writer<T> w(dest, *this, capacity);
+            while(!pq.empty()) {
+                auto const i = pq.top();
+                pq.pop();
+                w.push(readers[i]->next());
+                if(!readers[i]->empty()) pq.push(i);
+            }
+        };
+
+        while(runs.size() > fan_in) {
+            std::vector<Run> merged;
+            for(size_t i = 0; i < runs.size(); i += fan_in) {
+                merged.emplace_back(std::make_unique<ScratchFile>(scratch_dir_));
+                merge(runs.data() + i, std::min(fan_in, runs.size() - i), merged.back()->path());
+            }
+            runs = std::move(merged);
+        }
+
+        if(runs.size() == 1) {
+            std::filesystem::rename(runs[0]->path(), out);
+        } else {
+            merge(runs.data(), runs.size(), out);
+        }
+    }
+
+    uintmax_t lce(File& a, File& b, std::vector<char>& buf, uintmax_t const n, uintmax_t const i, uintmax_t const j) {
+        char* const x = buf.data();
+        char* const y = x + buf.size() / 2;
+
+        uintmax_t l = 0;
+        size_t chunk = LCE_CHUNK;
+        while(l < max_ref_len_ && i + l < n && j + l < n) {
+            size_t const m = std::min({uintmax_t(chunk), n - (i + l), n - (j + l), max_ref_len_ - l});
+            a.seek(i + l);
+            a.read(x, m);
+            b.seek(j + l);
+            b.read(y, m);
+
+            size_t const k = std::mismatch(x, x + m, y).first - x;
+            report_.compared(k + (k < m));
+            l += k;
+            if(k < m) break;
+
+            chunk = std::min(2 * chunk, buf.size() / 2);
+        }
+        return l;
+    }
+
+public:
+    EMFactorizer() : min_ref_len_(2), max_ref_len_(SIZE_MAX), ram_budget_(1ULL << 30), scratch_dir_(std::filesystem::temp_directory_path()), io_({0, 0}) {
+    }
+
+    /**
+     * \brief Factorizes the contents of the given file
+     * 
+     * \param input the path to the input file
+     * \param emit_literal the function to call for literal factors
+     * \param emit_reference the function to call for referencing factors
+     */
+    void factorize(std::filesystem::path const& input, EmitFunction emit_literal, EmitFunction emit_reference) {
+        io_ = {0, 0};
+        report_.reset(1);
+
+        uintmax_t const n = std::filesystem::file_size(input);
+        if(n == 0) return;
+
+        // initialize names with characters
+        report_.start(report_.suffix_array);
+        auto names = std::make_unique<ScratchFile>(scratch_dir_);
+        {
+            Reader<uint8_t> t(input, *this, buffer_capacity<uint8_t>());
+            Writer<Name> w(names->path(), *this, buffer_capacity<Name>());
+            for(uintmax_t i = 0; i < n; i++) w.push(Name{i, uintmax_t(t.next()) + 1});
+        }
+
+        // construct suffix array by prefix doubling
+        auto sa = std::make_unique<ScratchFile>(scratch_dir_);
+        for(uintmax_t h = 1;; h *= 2) {
+            // pair each name with that h positions to the right and sort
+            {
+                ScratchFile tuples(scratch_dir_);
+                {
+                    Reader<Name> r1(names->path(), *this, buffer_capacity<Name>());
+                    Reader<Name> r2(names->path(), *this, buffer_capacity<Name>(), h);
+                    Writer<Tuple> w(tuples.path(), *this, buffer_capacity<Tuple>());
+                    for(uintmax_t i = 0; i < n; i++) {
+                        w.push(Tuple{r1.next().rank, r2.empty() ? 0 : r2.next().rank, i});
+                    }
+                }
+                sort<Tuple>(tuples.path(), sa->path(), [](Tuple const& a, Tuple const& b){
+                    return a.rank1 < b.rank1 || (a.rank1 == b.rank1 && (a.rank2 < b.rank2 || (a.rank2 == b.rank2 && a.pos < b.pos)));
+                });
+            }
+
+            // rename
+            bool unique = true;
+            {
+                ScratchFile renamed(scratch_dir_);
+                {
+                    Reader<Tuple> r(sa->path(), *this, buffer_capacity<Tuple>());
+                    Writer<Name> w(renamed.path(), *this, buffer_capacity<Name>());
+
+                    Tuple prev = r.peek();
+                    uint64_t rank = 1;
+                    for(uintmax_t k = 0; k < n; k++) {
+                        auto const x = r.next();
+                        if(x.rank1 != prev.rank1 || x.rank2 != prev.rank2) {
+                            rank = k + 1;
+                        } else if(k > 0) {
+                            unique = false;
+                        }
+                        w.push(Name{x.pos, rank});
+                        prev = x;
+                    }
+                }
+
+                if(unique) break;
+                sort<Name>(renamed.path(), names->path(), [](Name const& a, Name const& b){ return a.pos < b.pos; });
+            }
+        }
+        names.reset();
+
+        // compute previous and next smaller values for each suffix array entry
+        report_.start(report_.inverse);
+        auto cands = std::make_unique<ScratchFile>(scratch_dir_);
+        {
+            ScratchFile unsorted(scratch_dir_);
+            {
+                Reader<Tuple> r(sa->path(), *this, buffer_capacity<Tuple>());
+                Writer<Candidates> w(unsorted.path(), *this, buffer_capacity<Candidates>());
+                Stack<StackEntry> stack(*this, buffer_capacity<StackEntry>());
+                while(!r.empty()) {
+                    auto const x = r.next().pos;
+                    while(!stack.empty() && stack.top().pos > x) {
+                        auto const e = stack.top();
+                        stack.pop();
+                        w.push(Candidates{e.pos, e.psv, x});
+                    }
+                    stack.push(StackEntry{x, stack.empty() ? NONE : stack.top().pos});
+                }
+                while(!stack.empty()) {
+                    auto const e = stack.top();
+                    stack.pop();
+                    w.push(Candidates{e.pos, e.psv, NONE});
+                }
+            }
+            sa.reset();
+            sort<Candidates>(unsorted.path(), cands->path(), [](Candidates const& a, Candidates const& b){ return a.pos < b.pos; });
+        }
+
+        // factorize
+        report_.start(report_.factorization);
+        {
+            Reader<Candidates> r(cands->path(), *this, buffer_capacity<Candidates>());
+            Reader<uint8_t> t(input, *this, buffer_capacity<uint8_t>());
+            File a(input, "rb", io_);
+            File b(input, "rb", io_);
+            std::vector<char> buf(2 * std::max(std::min(ram_budget_ / 16, MAX_BUFFER_BYTES), LCE_CHUNK));
+            report_.allocate(buf.size());
+
+            uintmax_t next = 0;
+            for(uintmax_t i = 0; i < n; i++) {
+                auto const c = r.next();
+                auto const x = t.next();
+                assert(c.pos == i);
+
+                if(i == next) {
+                    uintmax_t const psv_lcp = c.psv != NONE ? lce(a, b, buf, n, i, c.psv) : 0;
+                    uintmax_t const nsv_lcp = c.nsv != NONE ? lce(a, b, buf, n, i, c.nsv) : 0;
+
+                    //select maximum
+                    uintmax_t const max_lcp = std::max(psv_lcp, nsv_lcp);
+                    if(max_lcp >= min_ref_len_) {
+                        uintmax_t const max_pos = (max_lcp == psv_lcp) ? c.psv : c.nsv;
+                        assert(max_pos < i);
+
+                        // emit reference
+                        emit_reference(Factor(i - max_pos, max_lcp));
+                        next += max_lcp; //advance
+                    } else {
+                        // emit literal
+                        emit_literal(Factor((char)x));
+                        ++next; //advance
+                    }
+                }
+            }
+            report_.deallocate(buf.size());
+        }
+        report_.stop();
+    }
+
+    template<std::output_iterator<Factor> Output>
+    void factorize(std::filesystem::path const& input, Output out) {
+        auto emit = [&](Factor f){ *out++ = f; };
+        factorize(input, emit, emit);
+    }
+
+    /**
+     * \brief Reports the minimum length of a referencing factor
+     * 
+     * If a referencing factor is shorter than this length, a literal factor is emitted instead
+     * 
+     * \return the minimum reference length
+     */
+    size_t min_reference_length() const { return min_ref_len_; }
+
+    /**
+     * \brief Sets the minimum length of a referencing factor
+     * 
+     * If a referencing factor is shorter than this length, a literal factor is emitted instead
+     * 
+     * \param min_ref_len the minimum reference length
+     */
+    void min_reference_length(size_t min_ref_len) { min_ref_len_ = min_ref_len; }
+
+    /**
+     * \brief Reports the maximum length of a referencing factor
+     * 
+     * By default, the length is unbounded.
+     * 
+     * \return the maximum reference length
+     */
+    size_t max_reference_length() const { return max_ref_len_; }
+
+    /**
+     * \brief Sets the maximum length of a referencing factor
+     * 
+     * Longer matches are not split afterwards, but the factorization continues greedily with a fresh source after this many characters.
+     * If both lexicographic neighbours of a suffix match at least this many characters, the preceding one is chosen.
+     * 
+     * \param max_ref_len the maximum reference length
+     */
+    void max_reference_length(size_t max_ref_len) { max_ref_len_ = max_ref_len; }
+
+    /**
+     * \brief Reports the RAM budget for sorting and buffering
+     * 
+     * \return the RAM budget in bytes
+     */
+    size_t ram_budget() const { return ram_budget_; }
+
+    /**
+     * \brief Sets the RAM budget for sorting and buffering
+     * 
+     * \param ram_budget the RAM budget in bytes
+     */
+    void ram_budget(size_t ram_budget) { ram_budget_ = ram_budget; }
+
+    /**
+     * \brief Reports the directory in which scratch files are created
+     * 
+     * \return the scratch directory
+     */
+    std::filesystem::path const& scratch_directory() const { return scratch_dir_; }
+
+    /**
+     * \brief Sets the directory in which scratch files are created
+     * 
+     * By default, this is the system's temporary directory.
+     * 
+     * \param scratch_dir the scratch directory
+     */
+    void scratch_directory(std::filesystem::path const& scratch_dir) { scratch_dir_ = scratch_dir; }
+
+    /**
+     * \brief Reports the I/O volume generated by the most recent factorization
+     * 
+     * \return the I/O volume
+     */
+    IOVolume const& io_volume() const { return io_; }
+
+    /**
+     * \brief Reports on the phases of the most recent factorization
+     * 
+     * The report is only filled in if \ref report_enabled is \c true .
+     * 
+     * \return the report
+     */
+    Report const& report() const { return report_; }
+};
+
+}
+
+#endif
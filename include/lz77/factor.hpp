@@ -29,7 +29,9 @@
 #define _LZ77_FACTOR_HPP
 
 #include <algorithm>
+#include <concepts>
 #include <cstdint>
+#include <type_traits>
 
 namespace lz77 {
 
@@ -69,6 +71,17 @@ struct Factor {
      */
     inline Factor(char const c) : src(c), len(0) {}
 
+    /**
+     * \brief Constructs a literal factor for a wide symbol
+     * 
+     * The unsigned value of the symbol will be stored in \ref src and \ref len will be initialized as zero.
+     * 
+     * \param c the literal value
+     */
+    template<std::integral Char>
+    requires (sizeof(Char) > 1)
+    inline Factor(Char const c) : src(std::make_unsigned_t<Char>(c)), len(0) {}
+
     /**
      * \brief Constructs a factor
      * 
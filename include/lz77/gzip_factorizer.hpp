@@ -0,0 +1,774 @@
+/**
+ * lz77/gzip_factorizer.hpp
+ * part of pdinklag/lz77
+ * 
+ * MIT License
+ * 
+ * Copyright (c) Patrick Dinklage
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef _LZ77_GZIP_FACTOR_HPP
+#define _LZ77_GZIP_FACTOR_HPP
+
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <concepts>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <memory>
+#include <utility>
+
+#include "emit_function.hpp"
+#include "report.hpp"
+
+namespace lz77 {
+
+namespace internal {
+
+// computes the length of the common prefix of p and q, but at most max, comparing eight bytes at a time
+// may read up to seven bytes beyond max
+inline size_t common_prefix_length(uint8_t const* p, uint8_t const* q, size_t const max) {
+    size_t l = 0;
+    while(l < max) {
+        uint64_t a, b;
+        std::memcpy(&a, p + l, sizeof(uint64_t));
+        std::memcpy(&b, q + l, sizeof(uint64_t));
+
+        uint64_t const x = a ^ b;
+        if(x) {
+            // the first mismatching byte is the least significant one in little endian, the most significant one otherwise
+            if constexpr(std::endian::native == std::endian::little) {
+                l += std::countr_zero(x) / 8;
+            } else {
+                l += std::countl_zero(x) / 8;
+            }
+            return std::min(l, max);
+        }
+        l += sizeof(uint64_t);
+    }
+    return max;
+}
+
+}
+
+/**
+ * \brief Concept for hash functions that distribute positions among the hash chains of a \ref GzipFactorizer
+ * 
+ * A hash function maps the bytes starting at a position to one of `2^bits` hash chains.
+ * It may read at most four bytes.
+ */
+template<typename H>
+concept GzipHashFunction = requires(uint8_t const* p) {
+    { H::template hash<15>(p) } -> std::convertible_to<size_t>;
+};
+
+/**
+ * \brief The hash function used by gzip
+ * 
+ * It shifts and XORs the first three bytes, and reproduces gzip's hash chains exactly.
+ */
+struct GzipHash {
+    template<size_t bits>
+    static size_t hash(uint8_t const* p) {
+        constexpr size_t shift = (bits + 2) / 3; // as in gzip, the hash function is rolling (but isn't used as such)
+        constexpr size_t mask = (1ULL << bits) - 1;
+
+        size_t h = 0;
+        for(size_t i = 0; i < 3; i++) {
+            h = ((h << shift) ^ p[i]) & mask;
+        }
+        return h;
+    }
+};
+
+/**
+ * \brief Multiplicative hashing of the first four bytes
+ * 
+ * Positions only share a hash chain if they are likely to share four bytes, so the chains contain fewer candidates
+ * that turn out to be too short. In turn, matches of length three are usually missed.
+ * The factorization then no longer equals gzip's.
+ */
+struct MultiplicativeHash {
+    template<size_t bits>
+    static size_t hash(uint8_t const* p) {
+        uint32_t const x = uint32_t(p[0]) | (uint32_t(p[1]) << 8) | (uint32_t(p[2]) << 16) | (uint32_t(p[3]) << 24);
+        return (x * UINT32_C(2654435761)) >> (32 - bits);
+    }
+};
+
+/**
+ * \brief Computes the factorization of the input that gzip produces at the given compression level
+ * 
+ * This implementation produces exactly the same factorization as `gzip -1` through `gzip -9` without any subsequent encoding steps.
+ * It uses a sliding window and a number of heuristics to ensure a small encoding in the deflate format.
+ * Levels 1 to 3 use gzip's greedy strategy, which inserts the positions covered by a match into the hash chains only
+ * if the match is short. Levels 4 to 9 use lazy evaluation, deferring a match if the next position has a longer one.
+ * The levels differ in the lengths of the hash chains that are searched and the match lengths considered good enough.
+ * 
+ * The window size can be raised beyond gzip's 32 KiB, e.g., to 64 KiB as in deflate64 or up to 16 MiB, to find repetitions
+ * at larger distances. The hash table then grows along with the window so that the hash chains do not become longer.
+ * Only the default of 15 bits reproduces gzip.
+ * 
+ * The hash function that distributes positions among the hash chains can be exchanged as well, e.g., for a
+ * \ref MultiplicativeHash over four bytes, which shortens the chain walks at the expense of exactness.
+ * 
+ * \tparam level the gzip compression level, from 1 to 9
+ * \tparam window_bits the base-2 logarithm of the window size, from 15 to 24
+ * \tparam Hash the hash function, \ref GzipHash by default
+ * \tparam track_stats whether to collect \ref Stats on the match finder; otherwise, all bookkeeping is discarded at compile time
+ */
+template<unsigned level, unsigned window_bits = 15, GzipHashFunction Hash = GzipHash, bool track_stats = false>
+requires (level >= 1 && level <= 9 && window_bits >= 15 && window_bits <= 24)
+class GzipFactorizer {
+public:
+    /**
+     * \brief Statistics on the match finder
+     */
+    struct Stats {
+        /**
+         * \brief The number of hash chain searches
+         */
+        uintmax_t num_searches = 0;
+
+        /**
+         * \brief The total number of hash chain entries visited during all searches
+         */
+        uintmax_t total_chain_length = 0;
+
+        /**
+         * \brief The largest number of hash chain entries visited during a single search
+         */
+        uintmax_t max_chain_length = 0;
+
+        /**
+         * \brief Histogram of the numbers of hash chain entries visited per search
+         * 
+         * Entry \c i counts the searches that visited between \f$2^i\f$ and \f$2^{i+1}-1\f$ entries.
+         */
+        uintmax_t chain_length_histogram[13] = {};
+
+        /**
+         * \brief The total number of bytes compared to extend candidates that match in their first and last two bytes
+         */
+        uintmax_t bytes_compared = 0;
+
+        /**
+         * \brief The number of searches that stopped early because they found a nice match
+         */
+        uintmax_t nice_matches = 0;
+
+        /**
+         * \brief The number of searches with a shortened chain because the previous match was already good
+         */
+        uintmax_t good_matches = 0;
+
+        /**
+         * \brief The number of matches truncated to a literal because the next position had a longer one (lazy levels only)
+         */
+        uintmax_t greedy_skips = 0;
+    };
+
+private:
+    static constexpr bool track_stats_ = track_stats;
+
+    // gzip's configuration table, indexed by compression level
+    struct Config {
+        size_t good_match;       // reduce the chain length if the previous match is at least this long
+        size_t lazy_match;       // do not evaluate lazily above this match length, or do not insert longer matches (fast)
+        size_t nice_match;       // stop searching the chain once a match of this length is found
+        size_t max_chain_length; // maximum number of chain entries to search
+    };
+
+    static constexpr Config configuration_table_[10] = {
+        {0, 0, 0, 0}, // store only
+        {4, 4, 8, 4},
+        {4, 5, 16, 8},
+        {4, 6, 32, 32},
+        {4, 4, 16, 16},
+        {8, 16, 32, 32},
+        {8, 16, 128, 128},
+        {8, 32, 128, 256},
+        {32, 128, 258, 1024},
+        {32, 258, 258, 4096},
+    };
+
+    static constexpr bool fast_ = level <= 3; // use greedy deflate_fast rather than lazy evaluation
+
+    static constexpr size_t min_match_ = 3;
+    static constexpr size_t max_match_ = 258;
+    static constexpr size_t window_bits_ = window_bits;
+    static constexpr size_t window_size_ = 1ULL << window_bits_;
+    static constexpr size_t buf_capacity_ = 2 * window_size_;
+    static constexpr size_t window_mask_ = window_size_ - 1;
+    static constexpr size_t num_chains_ = 1ULL << window_bits_;
+    static constexpr size_t min_lookahead_ = max_match_ + min_match_ + 1;
+    static constexpr size_t overread_ = sizeof(uint64_t); // number of bytes that may be read beyond the end of the input
+    static constexpr size_t max_dist_ = window_size_ - min_lookahead_;
+    static constexpr size_t max_chain_length_ = configuration_table_[level].max_chain_length;
+    static constexpr size_t nice_match_ = configuration_table_[level].nice_match;
+    static constexpr size_t lazy_match_ = configuration_table_[level].lazy_match;
+    static constexpr size_t max_insert_length_ = lazy_match_; // fast only
+    static constexpr size_t good_match_ = configuration_table_[level].good_match;
+    static constexpr size_t good_laziness_ = 4;
+    static constexpr size_t too_far_ = 4096; // a minimum match is not worth its distance code beyond this, regardless of the window size
+
+    using WindowIndex = std::conditional<window_bits_ <= 15, uint16_t, uint32_t>::type;
+    static constexpr auto NIL = 0ULL;
+
+    inline size_t hash(const size_t p) const {
+        return Hash::template hash<window_bits_>(buf_ + p);
+    }
+
+    uint8_t* buffer_;      // memory
+    uint8_t const* buf_;   // current window, either the buffer or, for contiguous input, the input itself
+    uintmax_t buf_offs_;  // text position of first entry in buffer
+    size_t buf_avail_; // available bytes in buffer
+    size_t buf_pos_; // current read position in buffer
+
+    uintmax_t pos_;         // next text position to encode
+    size_t hash_only_;   // number of positions to skip - but still hash - after emitting a reference
+    size_t skip_;        // number of positions to skip without hashing after emitting a long reference (fast only)
+
+    size_t prev_length_;
+    uintmax_t prev_src_;
+    bool prev_match_exists_;
+
+    size_t match_length_;
+    uintmax_t match_src_;
+
+    size_t max_ref_len_;
+    size_t max_latency_;
+    size_t dict_len_; // number of leading input positions that are only hashed
+
+    WindowIndex* hashtable_; // memory
+    WindowIndex* head_; // head of hash chains
+    WindowIndex* prev_; // chains
+
+    EmitFunction emit_literal_;   // for the push interface
+    EmitFunction emit_reference_; // for the push interface
+
+    Stats stats_;
+    Report report_;
+
+    template<typename CharInput>
+    size_t advance(CharInput& begin, CharInput const& end, uint8_t* buf, size_t max) {
+        size_t num = 0;
+        while(num < max && begin != end) {
+            *buf++ = (uint8_t)*begin++;
+            ++num;
+        }
+        return num;
+    }
+
+    // searches the hash chain starting at src for a match longer than best_length at the current position
+    // returns the length of the longest match found, which is best_length if there is no longer one, and sets match_src_ accordingly
+    size_t longest_match(uintmax_t src, size_t const best_length) {
+        const size_t relative_pos = pos_ - buf_offs_;
+        const auto limit = relative_pos > max_dist_ ? relative_pos - max_dist_ : NIL;
+
+        if constexpr(track_stats_) {
+            if(best_length >= good_match_) ++stats_.good_matches;
+        }
+
+        size_t chain = (best_length >= good_match_) ? (max_chain_length_ / good_laziness_) : max_chain_length_;
+        size_t chain_length = 0; // for stats only
+
+        size_t match_length = best_length; // we want to beat the previous match at least
+
+        const uint8_t* const match_begin = buf_ + buf_pos_;
+        const uint8_t* const match_end = ((buf_pos_ + max_ref_len_ <= buf_avail_) ? match_begin + max_ref_len_ : buf_ + buf_avail_);
+        const size_t max_length = match_end - match_begin;
+        const uint16_t prefix = *(const uint16_t*)match_begin;
+        uint16_t suffix = *(const uint16_t*)(match_begin + match_length - 1);
+
+        do {
+            if constexpr(track_stats_) ++chain_length;
+
+            // prepare match
+            const uint8_t* p = match_begin;
+            const uint8_t* q = buf_ + src;
+            assert(q < p);
+
+            // if first two characters don't match OR we cannot become better, then don't even bother
+            if(prefix == *(const uint16_t*)q && suffix == *(const uint16_t*)(q + match_length - 1)) {
+                // already matched first two, the remaining bytes are compared eight at a time
+                // the buffer has enough room beyond the end of the input to read over it
+                const size_t length = (max_length > 2) ? 2 + internal::common_prefix_length(p + 2, q + 2, max_length - 2) : max_length;
+                report_.compared(length + 1);
+                if constexpr(track_stats_) stats_.bytes_compared += length + 1;
+
+                // check match
+                if(length > match_length) {
+                    match_src_ = src;
+                    match_length = length;
+
+                    if(length >= nice_match_ || length >= max_ref_len_) {
+                        // immediately break when finding a nice match
+                        if constexpr(track_stats_) ++stats_.nice_matches;
+                        break;
+                    }
+
+                    suffix = *(const uint16_t*)(buf_ + buf_pos_ + match_length - 1);
+                }
+            }
+        } while(--chain && (src = prev_[src & window_mask_]) > limit);
+
+        // stats
+        if constexpr(track_stats_) {
+            ++stats_.num_searches;
+            stats_.total_chain_length += chain_length;
+            stats_.max_chain_length = std::max(stats_.max_chain_length, (uintmax_t)chain_length);
+            ++stats_.chain_length_histogram[std::bit_width(chain_length) - 1];
+        }
+        return match_length;
+    }
+
+    // inserts the current position into the hash chains and returns the previous head of its chain
+    uintmax_t insert() {
+        const size_t relative_pos = pos_ - buf_offs_;
+        const auto h = hash(buf_pos_);
+        const uintmax_t src = head_[h];
+        prev_[relative_pos & window_mask_] = src;
+
+        assert(relative_pos < buf_capacity_);
+        head_[h] = relative_pos;
+        return src;
+    }
+
+    // processes the current position greedily like gzip's deflate_fast
+    void process_fast(EmitFunction& emit_literal, EmitFunction& emit_reference) {
+        if(skip_) {
+            --skip_;
+            return;
+        }
+
+        const size_t relative_pos = pos_ - buf_offs_;
+        uintmax_t src = insert();
+
+        if(hash_only_) {
+            --hash_only_;
+            return;
+        }
+
+        // find the longest match
+        // unlike in the lazy strategy, the length of the previous match is irrelevant and distant minimum matches are not ignored
+        size_t match_length = min_match_ - 1;
+        if(src != NIL && relative_pos - src <= max_dist_) {
+            match_length = longest_match(src, min_match_ - 1);
+        }
+
+        if(match_length >= min_match_) {
+            emit_reference(Factor(relative_pos - match_src_, match_length));
+            if(match_length <= max_insert_length_) {
+                hash_only_ = match_length - 1; // current position is already hashed
+            } else {
+                skip_ = match_length - 1;
+            }
+        } else {
+            emit_literal(Factor((char)buf_[buf_pos_]));
+        }
+    }
+
+    // processes the current position with lazy evaluation like gzip's deflate
+    void process_lazy(EmitFunction& emit_literal, EmitFunction& emit_reference) {
+        const size_t relative_pos = pos_ - buf_offs_;
+
+        // insert current string
+        uintmax_t src = insert();
+        
+        if(hash_only_) {
+            --hash_only_;
+        } else {
+            // store previous match
+            prev_length_ = match_length_;
+            prev_src_ = match_src_;
+            match_length_ = min_match_ - 1; // init to horrible
+
+            // find the longest match
+            if(src != NIL && prev_length_ < lazy_match_ && relative_pos - src <= max_dist_) {
+                match_length_ = longest_match(src, prev_length_);
+
+                // make match source global
+                match_src_ += buf_offs_;
+
+                // ignore a minimum match if it is too distant
+                if(match_length_ == min_match_ && pos_ - match_src_ > too_far_) {
+                    --match_length_;
+                }
+            }
+
+            // compare current match against previous match
+            if(prev_length_ >= min_match_ && match_length_ <= prev_length_) {
+                // previous match was better than current, emit
+                emit_reference(Factor(pos_ - 1 - prev_src_, prev_length_));
+                hash_only_ = prev_length_ - 2; // current and previous positions are already hashed
+
+                // reset
+                match_length_ = min_match_ - 1;
+                prev_match_exists_ = false;
+            } else if(prev_match_exists_) {
+                // current match is better, truncate previous match to a single literal
+                assert(buf_pos_ > 0);
+
+                if constexpr(track_stats_) {
+                    if(prev_length_ >= min_match_) ++stats_.greedy_skips;
+                }
+
+                emit_literal(Factor((char)buf_[buf_pos_ - 1]));
+            } else {
+                // there is no previous match to compare with, wait for next step
+                prev_match_exists_ = true;
+            }
+        }
+    }
+
+    void process(EmitFunction& emit_literal, EmitFunction& emit_reference) {
+        if constexpr(fast_) {
+            process_fast(emit_literal, emit_reference);
+        } else {
+            process_lazy(emit_literal, emit_reference);
+        }
+    }
+
+    // processes the current window while it has enough bytes left
+    void process_window(EmitFunction& emit_literal, EmitFunction& emit_reference) {
+        assert(buf_avail_ > min_lookahead_);
+        const size_t buf_border = buf_avail_ - min_lookahead_;
+        while(buf_pos_ < buf_border) {
+            process(emit_literal, emit_reference);
+
+            ++buf_pos_;
+            ++pos_;
+        }
+    }
+
+    // points the window into contiguous input of length n if it extends far enough to read beyond the window,
+    // otherwise copies the remaining input into the buffer
+    void map_window(uint8_t const* data, size_t const n) {
+        const size_t remaining = n - buf_offs_;
+        if(remaining >= buf_capacity_ + overread_) {
+            buf_ = data + buf_offs_;
+        } else {
+            std::memcpy(buffer_, data + buf_offs_, remaining);
+            std::fill(buffer_ + remaining, buffer_ + remaining + overread_, 0);
+            buf_ = buffer_;
+        }
+    }
+
+    // rebases the hash chains after the window slid
+    void rebase() {
+        // heads and chains are contiguous, so they are rebased in one branchless pass that compilers vectorize into saturating subtractions
+        constexpr WindowIndex shift = window_size_;
+        for(size_t i = 0; i < num_chains_ + window_size_; i++) {
+            hashtable_[i] -= std::min(hashtable_[i], shift); // entries that slide out of the window become NIL
+        }
+    }
+
+    // initializes a factorization
+    void reset() {
+        if constexpr(track_stats_) stats_ = Stats();
+
+        buf_offs_ = 0;
+        buf_avail_ = 0;
+        buf_pos_ = 0;
+
+        match_src_ = NIL;
+        match_length_ = min_match_ - 1;
+
+        prev_src_ = NIL;
+        prev_length_ = min_match_ - 1;
+        prev_match_exists_ = false;
+
+        hash_only_ = 0;
+        skip_ = 0;
+        
+        pos_ = 0;
+
+        std::fill(hashtable_, hashtable_ + num_chains_ + window_size_, NIL);
+
+        report_.reset(1);
+        report_.allocate(buf_capacity_ + min_lookahead_ + (num_chains_ + window_size_) * sizeof(WindowIndex));
+        report_.start(report_.factorization);
+    }
+
+    // copies input into the buffer, sliding it whenever it is full and there is more input
+    template<typename CharInput>
+    void push(CharInput& begin, CharInput const& end, EmitFunction& emit_literal, EmitFunction& emit_reference) {
+        while(begin != end) {
+            if(buf_avail_ == buf_capacity_) {
+                process_window(emit_literal, emit_reference);
+
+                // buffer ran short of min lookahead, slide
+                report_.start(report_.slide);
+                {
+                    assert(buf_pos_ >= window_size_);
+
+                    std::memcpy(buffer_, buffer_ + window_size_, window_size_);
+                    buf_pos_ -= window_size_;
+                    buf_offs_ += window_size_;
+                    buf_avail_ = window_size_;
+                }
+
+                rebase();
+                report_.start(report_.factorization);
+            }
+
+            // read more
+            buf_avail_ += advance(begin, end, buffer_ + buf_avail_, buf_capacity_ - buf_avail_);
+        }
+    }
+
+    // processes all remaining positions in the window so that the emitted factors cover all input so far
+    void drain(EmitFunction& emit_literal, EmitFunction& emit_reference) {
+        // like in gzip, the last positions are hashed including the bytes beyond the input, which are zero, but matches are cut off at its end
+        std::fill(buffer_ + buf_avail_, buffer_ + buf_avail_ + overread_, 0);
+        while(buf_pos_ < buf_avail_) {
+            process(emit_literal, emit_reference);
+            
+            ++pos_;
+            ++buf_pos_;
+        }
+
+        // emit the literal still waiting for lazy evaluation
+        if(prev_match_exists_) {
+            emit_literal(Factor((char)buf_[buf_pos_ - 1]));
+            prev_match_exists_ = false;
+        }
+        match_length_ = min_match_ - 1;
+    }
+
+    // processes the final window and finishes the factorization
+    void finish_window(EmitFunction& emit_literal, EmitFunction& emit_reference) {
+        drain(emit_literal, emit_reference);
+
+        report_.deallocate(buf_capacity_ + min_lookahead_ + (num_chains_ + window_size_) * sizeof(WindowIndex));
+        report_.stop();
+    }
+
+public:
+    GzipFactorizer() : max_ref_len_(max_match_), max_latency_(SIZE_MAX), dict_len_(0) {
+        const size_t bufsize = buf_capacity_ + min_lookahead_;
+        buffer_ = new uint8_t[bufsize];
+        for(size_t i = 0; i < bufsize; i++) buffer_[i] = 0;
+        
+        hashtable_ = new WindowIndex[num_chains_ + window_size_];
+        head_ = hashtable_;
+        prev_ = hashtable_ + num_chains_;
+    }
+
+    ~GzipFactorizer() {
+        delete[] buffer_;
+        delete[] hashtable_;
+    }
+
+    template<std::input_iterator Input>
+    requires (sizeof(std::iter_value_t<Input>) == 1)
+    void factorize(Input begin, Input const& end, EmitFunction emit_literal, EmitFunction emit_reference) {
+        reset();
+
+        if constexpr(std::contiguous_iterator<Input>) {
+            // match directly against the input, which is copied into the buffer only for the final window
+            // so that reading beyond its end is safe
+            uint8_t const* data = (uint8_t const*)std::to_address(begin);
+            const size_t n = end - begin;
+
+            buf_avail_ = std::min(n, buf_capacity_);
+            map_window(data, n);
+
+            // prime the hash chains with the dictionary, which lies within the first window
+            assert(dict_len_ <= buf_avail_);
+            while(buf_pos_ < dict_len_) {
+                insert();
+
+                ++buf_pos_;
+                ++pos_;
+            }
+
+            while(buf_offs_ + buf_avail_ < n) {
+                process_window(emit_literal, emit_reference);
+
+                // window ran short of min lookahead, slide
+                report_.start(report_.slide);
+                {
+                    assert(buf_pos_ >= window_size_);
+
+                    buf_pos_ -= window_size_;
+                    buf_offs_ += window_size_;
+                    buf_avail_ = std::min(n - buf_offs_, buf_capacity_);
+                    map_window(data, n);
+                }
+
+                rebase();
+                report_.start(report_.factorization);
+            }
+        } else {
+            buf_ = buffer_;
+            push(begin, end, emit_literal, emit_reference);
+        }
+
+        finish_window(emit_literal, emit_reference);
+    }
+
+    template<std::contiguous_iterator Input, std::output_iterator<Factor> Output>
+    requires (sizeof(std::iter_value_t<Input>) == 1)
+    void factorize(Input begin, Input const& end, Output out) {
+        auto emit = [&](Factor f){ *out++ = f; };
+        factorize(begin, end, emit, emit);
+    }
+
+    /**
+     * \brief Factorizes the input with the preceding text as a dictionary
+     * 
+     * The hash chains are primed with the dictionary like zlib's \c deflateSetDictionary does, so references may point into it,
+     * but the dictionary itself is not factorized. Only its last window is used.
+     * 
+     * \param dict_begin the beginning of the dictionary, which ends at the beginning of the input
+     * \param begin the beginning of the input
+     * \param end the end of the input
+     * \param emit_literal the function called for each literal factor
+     * \param emit_reference the function called for each referencing factor
+     */
+    template<std::contiguous_iterator Input>
+    requires (sizeof(std::iter_value_t<Input>) == 1)
+    void factorize(Input const& dict_begin, Input const& begin, Input const& end, EmitFunction emit_literal, EmitFunction emit_reference) {
+        assert(dict_begin <= begin);
+        dict_len_ = std::min((size_t)(begin - dict_begin), window_size_);
+        factorize(begin - dict_len_, end, emit_literal, emit_reference);
+        dict_len_ = 0;
+    }
+
+    /**
+     * \brief Starts an incremental factorization of input that is pushed via \ref feed
+     * 
+     * The result is the same as that of \ref factorize over the concatenation of all pushed input,
+     * but only the window is kept in memory.
+     * 
+     * \param emit_literal the function called for each literal factor
+     * \param emit_reference the function called for each referencing factor
+     */
+    void start(EmitFunction emit_literal, EmitFunction emit_reference) {
+        emit_literal_ = std::move(emit_literal);
+        emit_reference_ = std::move(emit_reference);
+        reset();
+        buf_ = buffer_;
+    }
+
+    /**
+     * \brief Pushes the next chunk of input into an incremental factorization
+     * 
+     * All factors that are determined by the input so far are emitted immediately.
+     * These are all factors except for those in the last few hundred bytes, which still depend on the following input.
+     * If more than the \ref max_latency may remain uncovered, the factorization is flushed.
+     * 
+     * \param begin the beginning of the chunk
+     * \param end the end of the chunk
+     */
+    template<std::input_iterator Input>
+    requires (sizeof(std::iter_value_t<Input>) == 1)
+    void feed(Input begin, Input const& end) {
+        push(begin, end, emit_literal_, emit_reference_);
+        if(buf_avail_ > min_lookahead_) process_window(emit_literal_, emit_reference_);
+
+        // bytes not yet covered by emitted factors, at most
+        const size_t uncovered = buf_avail_ - buf_pos_ + (prev_match_exists_ ? 1 : 0);
+        if(uncovered > max_latency_) flush();
+    }
+
+    /**
+     * \brief Emits the factors covering all input pushed so far
+     * 
+     * Like zlib's \c Z_SYNC_FLUSH , pending matches are settled and the last matches are cut off at the end of the input so far.
+     * The window remains intact, so that later input can still reference earlier input.
+     * Each flush may deviate from the factorization that gzip would produce.
+     */
+    void flush() {
+        drain(emit_literal_, emit_reference_);
+    }
+
+    /**
+     * \brief Finishes an incremental factorization, emitting the remaining factors
+     */
+    void finish() {
+        finish_window(emit_literal_, emit_reference_);
+    }
+
+    /**
+     * \brief Reports the maximum length of a referencing factor
+     * 
+     * By default, this is 258 as in gzip.
+     * 
+     * \return the maximum reference length
+     */
+    size_t max_reference_length() const { return max_ref_len_; }
+
+    /**
+     * \brief Sets the maximum length of a referencing factor
+     * 
+     * Matches are searched only up to this length, so that the factorization remains greedy in the sense of gzip.
+     * The length is clamped to the range from 3 to 258. Any value other than 258 deviates from the gzip factorization.
+     * 
+     * \param max_ref_len the maximum reference length
+     */
+    void max_reference_length(size_t max_ref_len) { max_ref_len_ = std::clamp(max_ref_len, min_match_, max_match_); }
+
+    /**
+     * \brief Reports the maximum number of pushed bytes that may remain uncovered by emitted factors after a \ref feed
+     * 
+     * By default, this is unbounded and the lookahead is only settled by \ref flush or \ref finish .
+     * 
+     * \return the maximum latency in bytes
+     */
+    size_t max_latency() const { return max_latency_; }
+
+    /**
+     * \brief Sets the maximum number of pushed bytes that may remain uncovered by emitted factors after a \ref feed
+     * 
+     * If more bytes may remain uncovered, the factorization is flushed automatically.
+     * Latencies up to the lookahead of 262 bytes flush after every \ref feed . Each flush may deviate from the gzip factorization.
+     * 
+     * \param max_latency the maximum latency in bytes
+     */
+    void max_latency(size_t max_latency) { max_latency_ = max_latency; }
+
+    /**
+     * \brief Reports on the phases of the most recent factorization
+     * 
+     * The report is only filled in if \ref report_enabled is \c true .
+     * 
+     * \return the report
+     */
+    Report const& report() const { return report_; }
+
+    /**
+     * \brief Reports statistics on the match finder during the most recent factorization
+     * 
+     * The statistics are only collected if \c track_stats is \c true .
+     * 
+     * \return the statistics
+     */
+    Stats const& stats() const { return stats_; }
+};
+
+}
+
+#endif
@@ -0,0 +1,168 @@
+/**
+ * lz77/inverse_suffix_array.hpp
+ * part of pdinklag/lz77
+ * 
+ * MIT License
+ * 
+ * Copyright (c) Patrick Dinklage
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef _LZ77_INVERSE_SUFFIX_ARRAY_HPP
+#define _LZ77_INVERSE_SUFFIX_ARRAY_HPP
+
+#include <algorithm>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#ifdef LIBSAIS_OPENMP
+#include <omp.h>
+#endif
+
+#include "allocation.hpp"
+#include "report.hpp"
+
+namespace lz77 {
+
+/**
+ * \brief Computes the inverse of a suffix array
+ * 
+ * The naive inversion <tt>isa[sa[i]] = i</tt> writes to a random location in every step, which causes a cache and TLB miss
+ * each time once the array exceeds the last level cache. For large inputs, this kernel therefore first partitions the
+ * pairs <tt>(sa[i], i)</tt> by the high bits of <tt>sa[i]</tt> into at most 4096 buckets, using a small write-combining buffer
+ * per bucket so that each write to the partitioned array fills whole cache lines. Each bucket then covers 1/4096 of the
+ * inverse suffix array, so its writes are confined to a contiguous range. That range stays cached while it is filled only
+ * as long as it fits into the last level cache, e.g., up to inverse suffix arrays of some tens of GiB. For larger inputs,
+ * the confinement still reduces TLB misses, but the scatter is no longer cache-resident and the gain over the naive
+ * inversion shrinks. This takes a temporary array of \c n pairs.
+ * 
+ * Both passes run in parallel if \c LIBSAIS_OPENMP is defined.
+ * 
+ * \tparam Index the array entry type
+ * \param sa the suffix array
+ * \param isa the output inverse suffix array, must have room for \c n entries
+ * \param n the number of entries
+ * \param report the report to record the temporary allocation in
+ * \param alloc the policy used to allocate the temporary array
+ */
+template<std::unsigned_integral Index>
+void inverse_suffix_array(Index const* sa, Index* isa, Index const n, Report& report, AllocationPolicy const& alloc = AllocationPolicy()) {
+    constexpr size_t MIN_PARTITION_SIZE = 1ULL << 22;
+    constexpr size_t BUCKET_BITS = 12;
+    constexpr size_t BUFFER_SIZE = 16;
+
+    if(n < MIN_PARTITION_SIZE) {
+        #ifdef LIBSAIS_OPENMP
+        #pragma omp parallel for
+        #endif
+        for(Index i = 0; i < n; i++) isa[sa[i]] = i;
+        return;
+    }
+
+    struct Pair {
+        Index pos;
+        Index rank;
+    };
+
+    // determine buckets
+    size_t shift = 0;
+    while(((size_t)(n - 1) >> shift) >= (1ULL << BUCKET_BITS)) ++shift;
+    size_t const num_buckets = ((size_t)(n - 1) >> shift) + 1;
+
+    #ifdef LIBSAIS_OPENMP
+    size_t const num_threads = omp_get_max_threads();
+    #else
+    size_t const num_threads = 1;
+    #endif
+
+    auto pairs = allocate_for_overwrite<Pair>(n, alloc);
+    report.allocate(n * sizeof(Pair));
+
+    // count bucket sizes for each thread's chunk
+    std::vector<size_t> offsets(num_threads * num_buckets, 0);
+    auto chunk_begin = [&](size_t const t){ return (size_t)n * t / num_threads; };
+
+    #ifdef LIBSAIS_OPENMP
+    #pragma omp parallel for schedule(static, 1)
+    #endif
+    for(size_t t = 0; t < num_threads; t++) {
+        auto* count = offsets.data() + t * num_buckets;
+        for(size_t i = chunk_begin(t); i < chunk_begin(t + 1); i++) ++count[sa[i] >> shift];
+    }
+
+    // compute offsets, ordered by bucket first and thread second so that each bucket is contiguous
+    std::vector<size_t> bucket_begin(num_buckets + 1);
+    {
+        size_t sum = 0;
+        for(size_t b = 0; b < num_buckets; b++) {
+            bucket_begin[b] = sum;
+            for(size_t t = 0; t < num_threads; t++) {
+                auto const count = offsets[t * num_buckets + b];
+                offsets[t * num_buckets + b] = sum;
+                sum += count;
+            }
+        }
+        bucket_begin[num_buckets] = sum;
+    }
+
+    // partition pairs, buffering a few of them per bucket so that each write to the partitioned array fills cache lines
+    #ifdef LIBSAIS_OPENMP
+    #pragma omp parallel for schedule(static, 1)
+    #endif
+    for(size_t t = 0; t < num_threads; t++) {
+        auto* offset = offsets.data() + t * num_buckets;
+        std::vector<Pair> buffer(num_buckets * BUFFER_SIZE);
+        std::vector<uint8_t> fill(num_buckets, 0);
+
+        for(size_t i = chunk_begin(t); i < chunk_begin(t + 1); i++) {
+            auto const b = sa[i] >> shift;
+            auto* buf = buffer.data() + b * BUFFER_SIZE;
+            buf[fill[b]++] = Pair { sa[i], Index(i) };
+            if(fill[b] == BUFFER_SIZE) {
+                std::memcpy(pairs.get() + offset[b], buf, BUFFER_SIZE * sizeof(Pair));
+                offset[b] += BUFFER_SIZE;
+                fill[b] = 0;
+            }
+        }
+
+        for(size_t b = 0; b < num_buckets; b++) {
+            std::memcpy(pairs.get() + offset[b], buffer.data() + b * BUFFER_SIZE, fill[b] * sizeof(Pair));
+        }
+    }
+
+    // scatter each bucket into its cached range of the inverse suffix array
+    #ifdef LIBSAIS_OPENMP
+    #pragma omp parallel for schedule(dynamic, 16)
+    #endif
+    for(size_t b = 0; b < num_buckets; b++) {
+        for(size_t j = bucket_begin[b]; j < bucket_begin[b + 1]; j++) {
+            isa[pairs[j].pos] = pairs[j].rank;
+        }
+    }
+
+    report.deallocate(n * sizeof(Pair));
+}
+
+}
+
+#endif
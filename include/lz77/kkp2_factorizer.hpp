@@ -36,15 +36,18 @@
 #include <cstdint>
 #include <iterator>
 #include <memory>
-
-#include <libsais.h>
-#include <libsais64.h>
+#include <span>
 
 #ifdef LIBSAIS_OPENMP
 #include <omp.h>
 #endif
 
+#include "allocation.hpp"
 #include "emit_function.hpp"
+#include "naive_factorizer.hpp"
+#include "report.hpp"
+#include "suffix_array.hpp"
+#include "window_engine.hpp"
 
 namespace lz77 {
 
@@ -56,56 +59,69 @@ namespace lz77 {
  * It comes from the popular paper "Linear Time Lempel-Ziv Factorization: Simple, Fast, Small"
  * due to Kärkkäinen, Kempa and Puglisi [CPM 2013].
  * 
+ * The input may consist of bytes or of 16-bit or 32-bit integer symbols (see \ref Symbol ).
+ * 
  * In the case of multiple sources being eligible for a factor, tie breaking is done based on the lexicographic order.
  * In other words, the factorization is neither leftmost nor rightmost.
  */
 class KKP2Factorizer {
 private:
     static constexpr size_t MAX_SIZE_32BIT = 1ULL << 31;
+    static constexpr size_t DEFAULT_SMALL_INPUT_THRESHOLD = 256;
 
     static constexpr size_t STACK_BITS = 16;
     static constexpr size_t STACK_SIZE = 1ULL << STACK_BITS;
     static constexpr size_t STACK_HALF = STACK_SIZE/2;
     static constexpr size_t STACK_MASK = STACK_SIZE - 1;
 
-    static size_t lce(std::string_view const& t, size_t const i, size_t const j) {
-        auto const n = t.length();
+    template<typename Char>
+    size_t lce(std::span<Char const> const& t, size_t const i, size_t const j) {
+        auto const n = t.size();
 
         size_t l = 0;
-        while(i + l < n && j + l < n && t[i + l] == t[j + l]) ++l;
+        while(l < max_ref_len_ && i + l < n && j + l < n && t[i + l] == t[j + l]) ++l;
 
+        report_.compared(l + (l < max_ref_len_ && i + l < n && j + l < n));
         return l;
     }
 
     size_t min_ref_len_;
+    size_t max_ref_len_;
+    size_t max_dist_;
+    bool non_overlapping_;
+    size_t small_input_threshold_;
+    AllocationPolicy alloc_;
+    Report report_;
 
-    template<bool require_64bit>
-    void factorize(std::string_view const& t, EmitFunction emit_literal, EmitFunction emit_reference) {
+    template<bool require_64bit, typename Char>
+    void factorize(std::span<Char const> const& t, EmitFunction emit_literal, EmitFunction emit_reference) {
         using Index = std::conditional_t<require_64bit, uint64_t, uint32_t>;
         using SignedIndex = std::make_signed_t<Index>;
 
+        if(non_overlapping_) {
+            internal::factorize_non_overlapping<Index>(t, min_ref_len_, max_ref_len_, max_dist_, alloc_, report_, emit_literal, emit_reference);
+            return;
+        }
+
+        if(max_dist_ < t.size()) {
+            internal::factorize_window<Index>(t, min_ref_len_, max_ref_len_, max_dist_, alloc_, report_, emit_literal, emit_reference);
+            return;
+        }
+
         // construct index data structures
         Index const n = t.size();
-        auto cs = std::make_unique<SignedIndex[]>(n+5);
+        report_.start(report_.suffix_array);
+        auto cs = allocate<SignedIndex>(n+5, alloc_);
+        report_.allocate((n+5) * sizeof(SignedIndex));
         {
-            auto sa = std::make_unique<Index[]>(n);
-            
-            if constexpr(require_64bit) {
-                #ifdef LIBSAIS_OPENMP
-                libsais64_omp((uint8_t const*)t.data(), (int64_t*)sa.get(), n, 0, nullptr, omp_get_max_threads());
-                #else
-                libsais64((uint8_t const*)t.data(), (int64_t*)sa.get(), n, 0, nullptr);
-                #endif
-            } else {
-                #ifdef LIBSAIS_OPENMP
-                libsais_omp((uint8_t const*)t.data(), (int32_t*)sa.get(), n, 0, nullptr, omp_get_max_threads());
-                #else
-                libsais((uint8_t const*)t.data(), (int32_t*)sa.get(), n, 0, nullptr);
-                #endif
-            }
+            auto sa = allocate<Index>(n, alloc_);
+            report_.allocate(n * sizeof(Index));
+            suffix_array(t, sa.get(), report_);
 
             // construct
+            report_.start(report_.inverse);
             auto stack = std::make_unique<SignedIndex[]>(STACK_SIZE + 5);
+            report_.allocate((STACK_SIZE + 5) * sizeof(SignedIndex));
             SignedIndex top = 0;
             stack[top] = 0;
 
@@ -136,9 +152,11 @@ private:
                 ++top;
                 stack[top] = sai;
             }
+            report_.deallocate((STACK_SIZE + 5) * sizeof(SignedIndex) + n * sizeof(Index));
         }
 
         // factorize
+        report_.start(report_.factorization);
         cs[0] = 0;
         size_t next = 1;
         for(size_t i = 1; i <= n; i++) {
@@ -167,18 +185,38 @@ private:
             cs[i] = nsv;
             cs[psv] = i;
         }
+        report_.deallocate((n+5) * sizeof(SignedIndex));
+        report_.stop();
     }
 
 public:
-    KKP2Factorizer() : min_ref_len_(2) {
+    KKP2Factorizer() : min_ref_len_(2), max_ref_len_(SIZE_MAX), max_dist_(SIZE_MAX), non_overlapping_(false), small_input_threshold_(DEFAULT_SMALL_INPUT_THRESHOLD) {
     }
 
     template<std::contiguous_iterator Input>
-    requires (sizeof(std::iter_value_t<Input>) == 1)
+    requires Symbol<std::iter_value_t<Input>>
     void factorize(Input begin, Input const& end, EmitFunction emit_literal, EmitFunction emit_reference) {
-        std::string_view const t(begin, end);
+        std::span<std::iter_value_t<Input> const> const t(std::to_address(begin), end - begin);
         size_t const n = t.size();
 
+        if(n <= small_input_threshold_) {
+            // small inputs are factorized faster without a suffix array and without starting threads
+            NaiveFactorizer naive;
+            naive.min_reference_length(min_ref_len_);
+            naive.max_reference_length(max_ref_len_);
+            naive.max_distance(max_dist_);
+            naive.non_overlapping(non_overlapping_);
+            naive.factorize(begin, end, emit_literal, emit_reference);
+            report_ = naive.report();
+            return;
+        }
+
+        #ifdef LIBSAIS_OPENMP
+        report_.reset(omp_get_max_threads());
+        #else
+        report_.reset(1);
+        #endif
+
         if(n < MAX_SIZE_32BIT) {
             factorize<false>(t, emit_literal, emit_reference);
         } else {
@@ -187,7 +225,7 @@ public:
     }
 
     template<std::contiguous_iterator Input, std::output_iterator<Factor> Output>
-    requires (sizeof(std::iter_value_t<Input>) == 1)
+    requires Symbol<std::iter_value_t<Input>>
     void factorize(Input begin, Input const& end, Output out) {
         auto emit = [&](Factor f){ *out++ = f; };
         factorize(begin, end, emit, emit);
@@ -210,6 +248,111 @@ public:
      * \param min_ref_len the minimum reference length
      */
     void min_reference_length(size_t min_ref_len) { min_ref_len_ = min_ref_len; }
+
+    /**
+     * \brief Reports the maximum length of a referencing factor
+     * 
+     * By default, the length is unbounded.
+     * 
+     * \return the maximum reference length
+     */
+    size_t max_reference_length() const { return max_ref_len_; }
+
+    /**
+     * \brief Sets the maximum length of a referencing factor
+     * 
+     * Longer matches are not split afterwards, but the factorization continues greedily with a fresh source after this many characters.
+     * If both lexicographic neighbours of a suffix match at least this many characters, the preceding one is chosen.
+     * 
+     * \param max_ref_len the maximum reference length
+     */
+    void max_reference_length(size_t max_ref_len) { max_ref_len_ = max_ref_len; }
+
+    /**
+     * \brief Reports the maximum distance between a referencing factor and its source
+     * 
+     * By default, the distance is unbounded.
+     * 
+     * \return the maximum distance
+     */
+    size_t max_distance() const { return max_dist_; }
+
+    /**
+     * \brief Sets the maximum distance between a referencing factor and its source
+     * 
+     * If this is smaller than the input length, each factor is the longest match whose source lies within the window
+     * of this many preceding positions.
+     * In that case, the factorization is computed using the suffix array, its inverse and a predecessor set of the window
+     * rather than the smaller values arrays.
+     * 
+     * \param max_dist the maximum distance
+     */
+    void max_distance(size_t max_dist) { max_dist_ = max_dist; }
+
+    /**
+     * \brief Reports whether referencing factors may overlap their sources
+     * 
+     * By default, overlaps are allowed.
+     * 
+     * \return \c true if no referencing factor overlaps its source
+     */
+    bool non_overlapping() const { return non_overlapping_; }
+
+    /**
+     * \brief Sets whether referencing factors may overlap their sources
+     * 
+     * If set, each factor is the longest match whose source ends before the factor begins, i.e., its length never exceeds its distance,
+     * and it can be decoded using a plain \c memcpy .
+     * The factorization is then computed by walking the suffix array outwards from each factor's position,
+     * using the LCP array and the inverse suffix array.
+     * This takes O(nz) time in the worst case for z factors, which is reached on periodic texts.
+     * 
+     * \param non_overlapping whether to forbid overlaps
+     */
+    void non_overlapping(bool non_overlapping) { non_overlapping_ = non_overlapping; }
+
+    /**
+     * \brief Reports the input length up to which the \ref NaiveFactorizer is used instead
+     * 
+     * The naive factorizer computes the same factorization without constructing a suffix array,
+     * which is faster for small inputs.
+     * 
+     * \return the small input threshold
+     */
+    size_t small_input_threshold() const { return small_input_threshold_; }
+
+    /**
+     * \brief Sets the input length up to which the \ref NaiveFactorizer is used instead
+     * 
+     * The naive factorizer computes the same factorization without constructing a suffix array,
+     * which is faster for small inputs. Setting the threshold to zero disables it.
+     * 
+     * \param threshold the small input threshold
+     */
+    void small_input_threshold(size_t threshold) { small_input_threshold_ = threshold; }
+
+    /**
+     * \brief Reports the policy used to allocate the suffix array and the arrays derived from it
+     * 
+     * \return the allocation policy
+     */
+    AllocationPolicy const& allocation_policy() const { return alloc_; }
+
+    /**
+     * \brief Sets the policy used to allocate the suffix array and the arrays derived from it
+     * 
+     * \param policy the allocation policy
+     */
+    void allocation_policy(AllocationPolicy const& policy) { alloc_ = policy; }
+
+    /**
+     * \brief Reports on the phases of the most recent factorization
+     * 
+     * The report is only filled in if \ref report_enabled is \c true .
+     * 
+     * \return the report
+     */
+    Report const& report() const { return report_; }
 };
 
 }
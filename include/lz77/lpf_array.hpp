@@ -0,0 +1,335 @@
+/**
+ * lz77/lpf_array.hpp
+ * part of pdinklag/lz77
+ * 
+ * MIT License
+ * 
+ * Copyright (c) Patrick Dinklage
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef _LZ77_LPF_ARRAY_HPP
+#define _LZ77_LPF_ARRAY_HPP
+
+#include <algorithm>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+#ifdef LIBSAIS_OPENMP
+#include <omp.h>
+#endif
+
+#include "allocation.hpp"
+#include "report.hpp"
+#include "suffix_array.hpp"
+#include "uint40.hpp"
+
+namespace lz77 {
+
+/**
+ * \brief Concept for the entry types of LPF and previous occurrence arrays
+ */
+template<typename Entry>
+concept LPFEntry = std::same_as<Entry, uint32_t> || std::same_as<Entry, uint40_t> || std::same_as<Entry, uint64_t>;
+
+namespace internal {
+
+// computes the longest previous factor of each text position and a corresponding previous occurrence,
+// following Ohlebusch and Gog [SPIRE 2011]:
+// scanning the suffix array, the previous and next smaller values of each position are found using a stack,
+// and the lengths of their longest common prefixes are range minima over the LCP array maintained along with it
+// the stack is kept implicitly by linking each position to its previous smaller value
+// LCP values are capped at max_lcp, so that ties between capped values are resolved in favour of the previous smaller value
+// plcp may alias lpf
+template<std::unsigned_integral Index, LPFEntry Entry>
+void lpf_scan(Index const* sa, Index const* plcp, Entry* lpf, Entry* prev_occ, Index const n, Index const max_lcp) {
+    Index const none = n;
+    Index top = none;
+    for(Index k = 0; k < n; k++) {
+        Index const x = sa[k];
+        Index l = std::min(plcp[x], max_lcp); // LCP with the preceding suffix
+        while(top != none && top > x) {
+            // x is the next smaller value of the top position
+            Index const y = top;
+            Index const psv_lcp = lpf[y];
+            top = prev_occ[y];
+
+            // prefer the previous smaller value in case of a tie
+            if(l > psv_lcp) {
+                lpf[y] = l;
+                prev_occ[y] = x;
+            }
+            l = std::min(l, psv_lcp);
+        }
+        lpf[x] = top != none ? l : 0;
+        prev_occ[x] = top;
+        top = x;
+    }
+}
+
+// block-parallel variant of lpf_scan
+// each block of the suffix array is first scanned independently
+// positions whose previous smaller value lies in a preceding block are the prefix minima of their block,
+// and positions whose next smaller value lies in a succeeding block are its suffix minima
+// these chains are recorded along with the LCP range minima towards the block boundaries,
+// and then each block resolves its chains against those of the other blocks using binary search
+// plcp may alias lpf
+template<std::unsigned_integral Index, LPFEntry Entry>
+void lpf_scan_blocks(Index const* sa, Index const* plcp, Entry* lpf, Entry* prev_occ, Index const n, Index const max_lcp, size_t const num_blocks) {
+    struct Link {
+        Index pos; // a text position
+        Index lcp; // the minimum LCP between it and the block boundary
+    };
+
+    struct Block {
+        std::vector<Link> prefix_minima; // in suffix array order, with LCP minima towards the block start
+        std::vector<Link> suffix_minima; // in suffix array order, with LCP minima towards the block end
+
+        Index min() const { return prefix_minima.back().pos; }
+        Index min_lcp() const { return std::min(prefix_minima.back().lcp, suffix_minima.front().lcp); }
+    };
+
+    if(n == 0) return;
+
+    Index const none = n;
+    Index const block_size = (n + num_blocks - 1) / num_blocks;
+    std::vector<Block> blocks((n + block_size - 1) / block_size);
+    ssize_t const num = blocks.size();
+
+    // scan blocks locally
+    #ifdef LIBSAIS_OPENMP
+    #pragma omp parallel for schedule(static, 1)
+    #endif
+    for(ssize_t b = 0; b < num; b++) {
+        Index const s = b * block_size;
+        Index const e = std::min(n, s + block_size);
+        auto& block = blocks[b];
+
+        Index top = none;
+        for(Index k = s; k < e; k++) {
+            Index const x = sa[k];
+            Index l = std::min(plcp[x], max_lcp);
+            while(top != none && top > x) {
+                Index const y = top;
+                Index const psv_lcp = lpf[y];
+                top = prev_occ[y];
+
+                // the previous smaller value of a prefix minimum is yet unknown, the decision is made when resolving it
+                if(top == none || l > psv_lcp) {
+                    lpf[y] = l;
+                    prev_occ[y] = x;
+                }
+                l = std::min(l, psv_lcp);
+            }
+            if(top == none) block.prefix_minima.push_back({x, l});
+            lpf[x] = l;
+            prev_occ[x] = top;
+            top = x;
+        }
+
+        // the remaining stack contains the suffix minima
+        Index lcp = std::numeric_limits<Index>::max();
+        while(top != none) {
+            block.suffix_minima.push_back({top, lcp});
+            Index const psv = prev_occ[top];
+            if(psv != none) lcp = std::min(lcp, Index(lpf[top]));
+            top = psv;
+        }
+        std::reverse(block.suffix_minima.begin(), block.suffix_minima.end());
+    }
+
+    // finds the previous smaller value of x in the blocks preceding block b, given the LCP minimum from the start of block b
+    auto find_psv = [&](ssize_t b, Index const x, Index lcp) {
+        while(--b >= 0) {
+            auto const& block = blocks[b];
+            if(block.min() < x) {
+                auto const it = std::partition_point(block.suffix_minima.begin(), block.suffix_minima.end(), [&](Link const& y){ return y.pos < x; });
+                return Link { (it - 1)->pos, std::min(lcp, (it - 1)->lcp) };
+            }
+            lcp = std::min(lcp, block.min_lcp());
+        }
+        return Link { none, 0 };
+    };
+
+    // finds the next smaller value of x in the blocks succeeding block b, given the LCP minimum towards the end of block b
+    auto find_nsv = [&](ssize_t b, Index const x, Index lcp) {
+        while(++b < num) {
+            auto const& block = blocks[b];
+            if(block.min() < x) {
+                auto const it = std::partition_point(block.prefix_minima.begin(), block.prefix_minima.end(), [&](Link const& y){ return y.pos > x; });
+                return Link { it->pos, std::min(lcp, it->lcp) };
+            }
+            lcp = std::min(lcp, block.min_lcp());
+        }
+        return Link { none, 0 };
+    };
+
+    // resolve chains
+    #ifdef LIBSAIS_OPENMP
+    #pragma omp parallel for schedule(static, 1)
+    #endif
+    for(ssize_t b = 0; b < num; b++) {
+        auto const& block = blocks[b];
+
+        // prefix minima except the block minimum have their next smaller value in the block
+        for(size_t j = 0; j + 1 < block.prefix_minima.size(); j++) {
+            auto const [x, lcp] = block.prefix_minima[j];
+            auto const psv = find_psv(b, x, lcp);
+            if(Index(lpf[x]) <= psv.lcp) {
+                lpf[x] = psv.lcp;
+                prev_occ[x] = psv.pos;
+            }
+        }
+
+        // suffix minima except the block minimum have their previous smaller value in the block
+        for(size_t j = 0; j < block.suffix_minima.size(); j++) {
+            auto const [x, lcp] = block.suffix_minima[j];
+            auto const psv = (j == 0) ? find_psv(b, x, block.prefix_minima.back().lcp) : Link { Index(prev_occ[x]), Index(lpf[x]) };
+            auto const nsv = find_nsv(b, x, lcp);
+
+            // prefer the previous smaller value in case of a tie
+            if(nsv.lcp > psv.lcp) {
+                lpf[x] = nsv.lcp;
+                prev_occ[x] = nsv.pos;
+            } else {
+                lpf[x] = psv.lcp;
+                prev_occ[x] = psv.pos;
+            }
+        }
+    }
+}
+
+// the number of blocks to scan the suffix array in
+// blocks are only used if multiple threads are available and the input is not tiny
+inline size_t lpf_num_blocks([[maybe_unused]] size_t const n) {
+    #ifdef LIBSAIS_OPENMP
+    constexpr size_t MIN_PARALLEL_SIZE = 1ULL << 16;
+    if(n >= MIN_PARALLEL_SIZE) return omp_get_max_threads();
+    #endif
+    return 1;
+}
+
+template<std::unsigned_integral Index, LPFEntry Entry, Symbol Char>
+void lpf_array(std::span<Char const> const t, Entry* lpf, Entry* prev_occ, Report& report, AllocationPolicy const& alloc, size_t const num_blocks, Index const max_lcp) {
+    // construct suffix array
+    Index const n = t.size();
+    report.start(report.suffix_array);
+    auto sa = allocate<Index>(n, alloc);
+    report.allocate(n * sizeof(Index));
+
+    suffix_array(t, sa.get(), report);
+
+    // compute the PLCP array, in place of the LPF array if the entry types match
+    report.start(report.inverse);
+    Buffer<Index> tmp;
+    Index* plcp;
+    if constexpr(std::same_as<Entry, Index>) {
+        plcp = lpf;
+    } else {
+        tmp = allocate<Index>(n, alloc);
+        report.allocate(n * sizeof(Index));
+        plcp = tmp.get();
+    }
+    plcp_array(t, (Index const*)sa.get(), plcp, report);
+
+    // compute LPF array
+    if(num_blocks > 1) {
+        lpf_scan_blocks((Index const*)sa.get(), (Index const*)plcp, lpf, prev_occ, n, max_lcp, num_blocks);
+    } else {
+        lpf_scan((Index const*)sa.get(), (Index const*)plcp, lpf, prev_occ, n, max_lcp);
+    }
+
+    if(tmp) report.deallocate(n * sizeof(Index));
+    report.deallocate(n * sizeof(Index));
+}
+
+}
+
+/**
+ * \brief Computes the longest previous factor (LPF) array and a corresponding previous occurrence of each text position
+ * 
+ * For each text position \c i , \c lpf[i] is the length of the longest prefix of suffix \c i that also starts at a preceding position,
+ * and \c prev_occ[i] is such a position. Among multiple eligible positions, the lexicographically closest preceding suffix is reported,
+ * preferring the lexicographically smaller one in case of a tie; this is the same choice as made by \ref LPFFactorizer and \ref KKP2Factorizer .
+ * If \c lpf[i] is zero, \c prev_occ[i] is either the text length or an arbitrary preceding position.
+ * 
+ * The computation takes linear time. The suffix array and PLCP array are constructed using libsais, in parallel if \c LIBSAIS_OPENMP is defined.
+ * In that case, the suffix array is also scanned in parallel blocks, one per thread, which requires additional memory
+ * proportional to the number of prefix and suffix minima within the blocks.
+ * Apart from the suffix array, no additional memory is needed if the entry type matches the internal index width
+ * (32 bits for inputs shorter than 2 GiB, 64 bits otherwise); otherwise, a temporary PLCP array is allocated.
+ * 
+ * The input may consist of bytes or of 16-bit or 32-bit integer symbols (see \ref Symbol ).
+ * 
+ * \tparam Entry the array entry type, either 32, 40 or 64 bits wide
+ * \param begin the input begin iterator
+ * \param end the input end iterator
+ * \param lpf the output LPF array, must have room for one entry per input symbol
+ * \param prev_occ the output previous occurrence array, must have room for one entry per input symbol
+ * \param report the report to record the phases in
+ * \param alloc the policy used to allocate temporary arrays
+ * \throws std::length_error if the input is too long to be indexed using the entry type
+ */
+template<LPFEntry Entry, std::contiguous_iterator Input>
+requires Symbol<std::iter_value_t<Input>>
+void lpf_array(Input begin, Input const& end, Entry* lpf, Entry* prev_occ, Report& report, AllocationPolicy const& alloc = AllocationPolicy()) {
+    constexpr size_t MAX_SIZE_32BIT = 1ULL << 31;
+    constexpr uint64_t MAX_ENTRY = (sizeof(Entry) == 4) ? UINT32_MAX : (sizeof(Entry) == 5) ? (1ULL << 40) - 1 : UINT64_MAX;
+
+    std::span<std::iter_value_t<Input> const> const t(std::to_address(begin), end - begin);
+    if(uint64_t(t.size()) > MAX_ENTRY) throw std::length_error("input too long for the LPF array entry type");
+
+    size_t const num_blocks = internal::lpf_num_blocks(t.size());
+    if(t.size() < MAX_SIZE_32BIT) {
+        internal::lpf_array<uint32_t>(t, lpf, prev_occ, report, alloc, num_blocks, UINT32_MAX);
+    } else {
+        internal::lpf_array<uint64_t>(t, lpf, prev_occ, report, alloc, num_blocks, UINT64_MAX);
+    }
+}
+
+/**
+ * \brief Computes the longest previous factor (LPF) array and a corresponding previous occurrence of each text position
+ * 
+ * See the overload taking a \ref Report for details.
+ * 
+ * \tparam Entry the array entry type, either 32, 40 or 64 bits wide
+ * \param begin the input begin iterator
+ * \param end the input end iterator
+ * \param lpf the output LPF array, must have room for one entry per input symbol
+ * \param prev_occ the output previous occurrence array, must have room for one entry per input symbol
+ */
+template<LPFEntry Entry, std::contiguous_iterator Input>
+requires Symbol<std::iter_value_t<Input>>
+void lpf_array(Input begin, Input const& end, Entry* lpf, Entry* prev_occ) {
+    Report report;
+    lpf_array(begin, end, lpf, prev_occ, report);
+}
+
+}
+
+#endif
@@ -34,24 +34,33 @@
 #include <cstddef>
 #include <cstdint>
 #include <iterator>
+#include <limits>
 #include <memory>
-
-#include <libsais.h>
-#include <libsais64.h>
+#include <span>
 
 #ifdef LIBSAIS_OPENMP
 #include <omp.h>
 #endif
 
+#include "allocation.hpp"
 #include "emit_function.hpp"
+#include "lpf_array.hpp"
+#include "naive_factorizer.hpp"
+#include "report.hpp"
+#include "suffix_array.hpp"
+#include "window_engine.hpp"
 
 namespace lz77 {
 
 /**
  * \brief Computes an exact Lempel-Ziv 77 factorization of the input by simulating the longest previous factor (LPF) array
  * 
- * The algorithm first computes the suffix array, its inverse and the LCP array, and then uses it to simulate a scan of the LPF array
- * to compute greedily the Lempel-Ziv 77 parse.
+ * The algorithm first computes the suffix array and the permuted LCP array, and from them the LPF array and previous occurrences
+ * in linear time (see \ref lpf_array ). It then scans the LPF array to compute greedily the Lempel-Ziv 77 parse.
+ * Factor lengths are obtained from range minima over the LCP array rather than by comparing characters,
+ * so the running time is linear in the worst case and does not depend on the length of repetitions.
+ * 
+ * The input may consist of bytes or of 16-bit or 32-bit integer symbols (see \ref Symbol ).
  * 
  * In the case of multiple sources being eligible for a factor, tie breaking is done based on the lexicographic order.
  * In other words, the factorization is neither leftmost nor rightmost.
@@ -59,72 +68,55 @@ namespace lz77 {
 class LPFFactorizer {
 private:
     static constexpr size_t MAX_SIZE_32BIT = 1ULL << 31;
-
-    static size_t lce(std::string_view const& t, size_t const i, size_t const j) {
-        auto const n = t.length();
-
-        size_t l = 0;
-        while(i + l < n && j + l < n && t[i + l] == t[j + l]) ++l;
-
-        return l;
-    }
+    static constexpr size_t DEFAULT_SMALL_INPUT_THRESHOLD = 256;
 
     size_t min_ref_len_;
+    size_t max_ref_len_;
+    size_t max_dist_;
+    bool non_overlapping_;
+    size_t lazy_match_;
+    size_t small_input_threshold_;
+    AllocationPolicy alloc_;
+    Report report_;
 
-    template<bool require_64bit>
-    void factorize(std::string_view const& t, EmitFunction emit_literal, EmitFunction emit_reference) {
+    template<bool require_64bit, typename Char>
+    void factorize(std::span<Char const> const& t, EmitFunction emit_literal, EmitFunction emit_reference) {
         using Index = std::conditional_t<require_64bit, uint64_t, uint32_t>;
 
-        // construct suffix array, inverse suffix array and lcp array
-        Index const n = t.size();
-        auto sa = std::make_unique<Index[]>(n);
-        auto isa = std::make_unique<Index[]>(n);
-
-        if constexpr(require_64bit) {
-            #ifdef LIBSAIS_OPENMP
-            libsais64_omp((uint8_t const*)t.data(), (int64_t*)sa.get(), n, 0, nullptr, omp_get_max_threads());
-            #else
-            libsais64((uint8_t const*)t.data(), (int64_t*)sa.get(), n, 0, nullptr);
-            #endif
-        } else {
-            #ifdef LIBSAIS_OPENMP
-            libsais_omp((uint8_t const*)t.data(), (int32_t*)sa.get(), n, 0, nullptr, omp_get_max_threads());
-            #else
-            libsais((uint8_t const*)t.data(), (int32_t*)sa.get(), n, 0, nullptr);
-            #endif
+        if(non_overlapping_) {
+            internal::factorize_non_overlapping<Index>(t, min_ref_len_, max_ref_len_, max_dist_, alloc_, report_, emit_literal, emit_reference);
+            return;
         }
 
-        #ifdef LIBSAIS_OPENMP
-        #pragma omp parallel for
-        for(Index i = 0; i < n; i++) isa[sa[i]] = i;
-        #else
-        for(Index i = 0; i < n; i++) isa[sa[i]] = i;
-        #endif
+        if(max_dist_ < t.size()) {
+            internal::factorize_window<Index>(t, min_ref_len_, max_ref_len_, max_dist_, alloc_, report_, emit_literal, emit_reference);
+            return;
+        }
+
+        // compute LPF array and previous occurrences
+        Index const n = t.size();
+        auto lpf = allocate<Index>(n, alloc_);
+        auto prev = allocate<Index>(n, alloc_);
+        report_.allocate(2 * n * sizeof(Index));
+        Index const max_lcp = std::min(max_ref_len_, size_t(std::numeric_limits<Index>::max()));
+        internal::lpf_array<Index>(t, lpf.get(), prev.get(), report_, alloc_, internal::lpf_num_blocks(n), max_lcp);
 
         // factorize
+        report_.start(report_.factorization);
         for(size_t i = 0; i < n;) {
-            // get SA position for suffix i
-            size_t const cur_pos = isa[i];
-
-            // compute PSV and NSV
-            ssize_t psv_pos = (ssize_t)cur_pos - 1;
-            while (psv_pos >= 0 && sa[psv_pos] > i) --psv_pos;
-            size_t const psv_lcp = psv_pos >= 0 ? lce(t, i, (size_t)sa[psv_pos]) : 0;
-
-            size_t nsv_pos = cur_pos + 1;
-            while(nsv_pos < n && sa[nsv_pos] > i) ++nsv_pos;
-            size_t const nsv_lcp = nsv_pos < n ? lce(t, i, (size_t)sa[nsv_pos]) : 0;
-
-            //select maximum
-            size_t const max_lcp = std::max(psv_lcp, nsv_lcp);
-            if(max_lcp >= min_ref_len_) {
-                ssize_t const max_pos = (max_lcp == psv_lcp) ? psv_pos : nsv_pos;
-                assert(max_pos >= 0);
-                assert(max_pos < n);
-                assert(sa[max_pos] < i);
-                
+            size_t const max_lcp = lpf[i];
+            if(max_lcp > 0 && max_lcp >= min_ref_len_) {
+                assert(prev[i] < i);
+
+                // lazy evaluation: defer the match if the next position has a longer one
+                if(max_lcp < lazy_match_ && i + 1 < n && lpf[i + 1] > max_lcp) {
+                    emit_literal(Factor(t[i]));
+                    ++i; //advance
+                    continue;
+                }
+
                 // emit reference
-                emit_reference(Factor(i - sa[max_pos], max_lcp));
+                emit_reference(Factor(i - prev[i], max_lcp));
                 i += max_lcp; //advance
             } else {
                 // emit literal
@@ -132,18 +124,38 @@ private:
                 ++i; //advance
             }
         }
+        report_.deallocate(2 * n * sizeof(Index));
+        report_.stop();
     }
 
 public:
-    LPFFactorizer() : min_ref_len_(2) {
+    LPFFactorizer() : min_ref_len_(2), max_ref_len_(SIZE_MAX), max_dist_(SIZE_MAX), non_overlapping_(false), lazy_match_(0), small_input_threshold_(DEFAULT_SMALL_INPUT_THRESHOLD) {
     }
 
     template<std::contiguous_iterator Input>
-    requires (sizeof(std::iter_value_t<Input>) == 1)
+    requires Symbol<std::iter_value_t<Input>>
     void factorize(Input begin, Input const& end, EmitFunction emit_literal, EmitFunction emit_reference) {
-        std::string_view const t(begin, end);
+        std::span<std::iter_value_t<Input> const> const t(std::to_address(begin), end - begin);
         size_t const n = t.size();
 
+        if(n <= small_input_threshold_ && lazy_match_ == 0) {
+            // small inputs are factorized faster without a suffix array and without starting threads
+            NaiveFactorizer naive;
+            naive.min_reference_length(min_ref_len_);
+            naive.max_reference_length(max_ref_len_);
+            naive.max_distance(max_dist_);
+            naive.non_overlapping(non_overlapping_);
+            naive.factorize(begin, end, emit_literal, emit_reference);
+            report_ = naive.report();
+            return;
+        }
+
+        #ifdef LIBSAIS_OPENMP
+        report_.reset(omp_get_max_threads());
+        #else
+        report_.reset(1);
+        #endif
+
         if(n < MAX_SIZE_32BIT) {
             factorize<false>(t, emit_literal, emit_reference);
         } else {
@@ -152,7 +164,7 @@ public:
     }
 
     template<std::contiguous_iterator Input, std::output_iterator<Factor> Output>
-    requires (sizeof(std::iter_value_t<Input>) == 1)
+    requires Symbol<std::iter_value_t<Input>>
     void factorize(Input begin, Input const& end, Output out) {
         auto emit = [&](Factor f){ *out++ = f; };
         factorize(begin, end, emit, emit);
@@ -175,6 +187,134 @@ public:
      * \param min_ref_len the minimum reference length
      */
     void min_reference_length(size_t min_ref_len) { min_ref_len_ = min_ref_len; }
+
+    /**
+     * \brief Reports the maximum length of a referencing factor
+     * 
+     * By default, the length is unbounded.
+     * 
+     * \return the maximum reference length
+     */
+    size_t max_reference_length() const { return max_ref_len_; }
+
+    /**
+     * \brief Sets the maximum length of a referencing factor
+     * 
+     * Longer matches are not split afterwards, but the factorization continues greedily with a fresh source after this many characters.
+     * If both lexicographic neighbours of a suffix match at least this many characters, the preceding one is chosen.
+     * 
+     * \param max_ref_len the maximum reference length
+     */
+    void max_reference_length(size_t max_ref_len) { max_ref_len_ = max_ref_len; }
+
+    /**
+     * \brief Reports the maximum distance between a referencing factor and its source
+     * 
+     * By default, the distance is unbounded.
+     * 
+     * \return the maximum distance
+     */
+    size_t max_distance() const { return max_dist_; }
+
+    /**
+     * \brief Sets the maximum distance between a referencing factor and its source
+     * 
+     * If this is smaller than the input length, each factor is the longest match whose source lies within the window
+     * of this many preceding positions.
+     * In that case, the factorization is computed using the suffix array, its inverse and a predecessor set of the window
+     * rather than the smaller values arrays.
+     * 
+     * \param max_dist the maximum distance
+     */
+    void max_distance(size_t max_dist) { max_dist_ = max_dist; }
+
+    /**
+     * \brief Reports whether referencing factors may overlap their sources
+     * 
+     * By default, overlaps are allowed.
+     * 
+     * \return \c true if no referencing factor overlaps its source
+     */
+    bool non_overlapping() const { return non_overlapping_; }
+
+    /**
+     * \brief Sets whether referencing factors may overlap their sources
+     * 
+     * If set, each factor is the longest match whose source ends before the factor begins, i.e., its length never exceeds its distance,
+     * and it can be decoded using a plain \c memcpy .
+     * The factorization is then computed by walking the suffix array outwards from each factor's position,
+     * using the LCP array and the inverse suffix array.
+     * This takes O(nz) time in the worst case for z factors, which is reached on periodic texts.
+     * 
+     * \param non_overlapping whether to forbid overlaps
+     */
+    void non_overlapping(bool non_overlapping) { non_overlapping_ = non_overlapping; }
+
+    /**
+     * \brief Reports the match length below which matches are evaluated lazily
+     * 
+     * By default, this is zero, i.e., the factorization is greedy.
+     * 
+     * \return the lazy match length
+     */
+    size_t lazy_match_length() const { return lazy_match_; }
+
+    /**
+     * \brief Sets the match length below which matches are evaluated lazily
+     * 
+     * Like gzip's lazy evaluation, a match shorter than this is deferred in favour of a literal if the next position has a longer match.
+     * The deferral may repeat, and the longest previous factor array provides the match at every position regardless of distance,
+     * so the window is unbounded. Setting this to \c SIZE_MAX always evaluates lazily, setting it to zero yields the greedy factorization.
+     * 
+     * Lazy evaluation only applies to the unbounded factorization, i.e., it is ignored if a maximum distance is set or
+     * overlaps are forbidden. It always uses the suffix array, regardless of the small input threshold.
+     * 
+     * \param lazy_match the lazy match length
+     */
+    void lazy_match_length(size_t lazy_match) { lazy_match_ = lazy_match; }
+
+    /**
+     * \brief Reports the input length up to which the \ref NaiveFactorizer is used instead
+     * 
+     * The naive factorizer computes the same factorization without constructing a suffix array,
+     * which is faster for small inputs.
+     * 
+     * \return the small input threshold
+     */
+    size_t small_input_threshold() const { return small_input_threshold_; }
+
+    /**
+     * \brief Sets the input length up to which the \ref NaiveFactorizer is used instead
+     * 
+     * The naive factorizer computes the same factorization without constructing a suffix array,
+     * which is faster for small inputs. Setting the threshold to zero disables it.
+     * 
+     * \param threshold the small input threshold
+     */
+    void small_input_threshold(size_t threshold) { small_input_threshold_ = threshold; }
+
+    /**
+     * \brief Reports the policy used to allocate the suffix array and the arrays derived from it
+     * 
+     * \return the allocation policy
+     */
+    AllocationPolicy const& allocation_policy() const { return alloc_; }
+
+    /**
+     * \brief Sets the policy used to allocate the suffix array and the arrays derived from it
+     * 
+     * \param policy the allocation policy
+     */
+    void allocation_policy(AllocationPolicy const& policy) { alloc_ = policy; }
+
+    /**
+     * \brief Reports on the phases of the most recent factorization
+     * 
+     * The report is only filled in if \ref report_enabled is \c true .
+     * 
+     * \return the report
+     */
+    Report const& report() const { return report_; }
 };
 
 }
@@ -0,0 +1,278 @@
+/**
+ * lz77/naive_factorizer.hpp
+ * part of pdinklag/lz77
+ * 
+ * MIT License
+ * 
+ * Copyright (c) Patrick Dinklage
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef _LZ77_NAIVE_FACTORIZER_HPP
+#define _LZ77_NAIVE_FACTORIZER_HPP
+
+#include <algorithm>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <span>
+#include <type_traits>
+
+#include "emit_function.hpp"
+#include "report.hpp"
+#include "suffix_array.hpp"
+
+namespace lz77 {
+
+/**
+ * \brief Computes the same factorization as \ref KKP2Factorizer and \ref LPFFactorizer by naive scanning.
+ * 
+ * For each factor, all preceding positions are compared against the current suffix to find its lexicographic
+ * predecessor and successor among them, i.e., the previous and next smaller values that the suffix array based
+ * factorizers would find. This takes cubic time in the worst case, but needs no auxiliary memory and no threads,
+ * which makes it the fastest choice for small inputs.
+ * 
+ * The input may consist of bytes or of 16-bit or 32-bit integer symbols (see \ref Symbol ).
+ */
+class NaiveFactorizer {
+private:
+    // symbols are compared as unsigned values, consistent with the suffix array
+    template<typename Char>
+    static std::make_unsigned_t<Char> sym(Char const c) { return std::make_unsigned_t<Char>(c); }
+
+    template<typename Char>
+    size_t lce(std::span<Char const> const& t, size_t const i, size_t const j, size_t l = 0) {
+        auto const n = t.size();
+        while(i + l < n && j + l < n && t[i + l] == t[j + l]) ++l;
+
+        report_.compared(l + (i + l < n && j + l < n));
+        return l;
+    }
+
+    // tests whether suffix a is lexicographically smaller than suffix b, given that they share a prefix of length l
+    template<typename Char>
+    bool less(std::span<Char const> const& t, size_t const a, size_t const b, size_t const l) {
+        auto const n = t.size();
+        auto const m = lce(t, a, b, l);
+        if(a + m == n) return true;
+        if(b + m == n) return false;
+        return sym(t[a + m]) < sym(t[b + m]);
+    }
+
+    size_t min_ref_len_;
+    size_t max_ref_len_;
+    size_t max_dist_;
+    bool non_overlapping_;
+    Report report_;
+
+    // emits the factor starting at position i that does not overlap its source and returns its length
+    // among the longest sources, the lexicographically closest smaller suffix is preferred, then the closest greater suffix
+    template<typename Char>
+    size_t factorize_non_overlapping(std::span<Char const> const& t, size_t const i, EmitFunction emit_literal, EmitFunction emit_reference) {
+        auto const n = t.size();
+
+        size_t psv = n, psv_len = 0;
+        size_t nsv = n, nsv_len = 0;
+        for(size_t j = (i > max_dist_) ? i - max_dist_ : 0; j < i; j++) {
+            size_t const l = lce(t, i, j);
+            size_t const len = std::min({l, i - j, max_ref_len_});
+            if(len == 0) continue;
+
+            if(i + l < n && sym(t[j + l]) < sym(t[i + l])) {
+                if(len > psv_len || (len == psv_len && less(t, psv, j, 0))) {
+                    psv = j;
+                    psv_len = len;
+                }
+            } else {
+                if(len > nsv_len || (len == nsv_len && less(t, j, nsv, 0))) {
+                    nsv = j;
+                    nsv_len = len;
+                }
+            }
+        }
+
+        size_t const max_len = std::max(psv_len, nsv_len);
+        if(max_len > 0 && max_len >= min_ref_len_) {
+            size_t const max_pos = (nsv_len > psv_len) ? nsv : psv;
+            emit_reference(Factor(i - max_pos, max_len));
+            return max_len;
+        } else {
+            emit_literal(Factor(t[i]));
+            return 1;
+        }
+    }
+
+    template<typename Char>
+    void factorize(std::span<Char const> const& t, EmitFunction emit_literal, EmitFunction emit_reference) {
+        auto const n = t.size();
+
+        report_.start(report_.factorization);
+        for(size_t i = 0; i < n;) {
+            if(non_overlapping_) {
+                i += factorize_non_overlapping(t, i, emit_literal, emit_reference);
+                continue;
+            }
+
+            // find lexicographic predecessor and successor among the preceding positions within the window
+            size_t psv = n, psv_lcp = 0;
+            size_t nsv = n, nsv_lcp = 0;
+            for(size_t j = (i > max_dist_) ? i - max_dist_ : 0; j < i; j++) {
+                size_t const l = lce(t, i, j);
+                if(i + l < n && sym(t[j + l]) < sym(t[i + l])) {
+                    // suffix j is smaller, the predecessor is the largest such suffix
+                    if(psv == n || l > psv_lcp || (l == psv_lcp && less(t, psv, j, l))) {
+                        psv = j;
+                        psv_lcp = l;
+                    }
+                } else {
+                    // suffix j is greater, the successor is the smallest such suffix
+                    if(nsv == n || l > nsv_lcp || (l == nsv_lcp && less(t, j, nsv, l))) {
+                        nsv = j;
+                        nsv_lcp = l;
+                    }
+                }
+            }
+
+            // cap lengths, then select maximum
+            psv_lcp = std::min(psv_lcp, max_ref_len_);
+            nsv_lcp = std::min(nsv_lcp, max_ref_len_);
+            size_t const max_lcp = std::max(psv_lcp, nsv_lcp);
+            if(max_lcp > 0 && max_lcp >= min_ref_len_) {
+                size_t const max_pos = (max_lcp == psv_lcp) ? psv : nsv;
+
+                // emit reference
+                emit_reference(Factor(i - max_pos, max_lcp));
+                i += max_lcp; //advance
+            } else {
+                // emit literal
+                emit_literal(Factor(t[i]));
+                ++i; //advance
+            }
+        }
+        report_.stop();
+    }
+
+public:
+    NaiveFactorizer() : min_ref_len_(2), max_ref_len_(SIZE_MAX), max_dist_(SIZE_MAX), non_overlapping_(false) {
+    }
+
+    template<std::contiguous_iterator Input>
+    requires Symbol<std::iter_value_t<Input>>
+    void factorize(Input begin, Input const& end, EmitFunction emit_literal, EmitFunction emit_reference) {
+        std::span<std::iter_value_t<Input> const> const t(std::to_address(begin), end - begin);
+        report_.reset(1);
+        factorize(t, emit_literal, emit_reference);
+    }
+
+    template<std::contiguous_iterator Input, std::output_iterator<Factor> Output>
+    requires Symbol<std::iter_value_t<Input>>
+    void factorize(Input begin, Input const& end, Output out) {
+        auto emit = [&](Factor f){ *out++ = f; };
+        factorize(begin, end, emit, emit);
+    }
+
+    /**
+     * \brief Reports the minimum length of a referencing factor
+     * 
+     * If a referencing factor is shorter than this length, a literal factor is emitted instead
+     * 
+     * \return the minimum reference length
+     */
+    size_t min_reference_length() const { return min_ref_len_; }
+
+    /**
+     * \brief Sets the minimum length of a referencing factor
+     * 
+     * If a referencing factor is shorter than this length, a literal factor is emitted instead
+     * 
+     * \param min_ref_len the minimum reference length
+     */
+    void min_reference_length(size_t min_ref_len) { min_ref_len_ = min_ref_len; }
+
+    /**
+     * \brief Reports the maximum length of a referencing factor
+     * 
+     * By default, the length is unbounded.
+     * 
+     * \return the maximum reference length
+     */
+    size_t max_reference_length() const { return max_ref_len_; }
+
+    /**
+     * \brief Sets the maximum length of a referencing factor
+     * 
+     * Longer matches are not split afterwards, but the factorization continues greedily with a fresh source after this many characters.
+     * If both lexicographic neighbours of a suffix match at least this many characters, the preceding one is chosen.
+     * 
+     * \param max_ref_len the maximum reference length
+     */
+    void max_reference_length(size_t max_ref_len) { max_ref_len_ = max_ref_len; }
+
+    /**
+     * \brief Reports the maximum distance between a referencing factor and its source
+     * 
+     * By default, the distance is unbounded.
+     * 
+     * \return the maximum distance
+     */
+    size_t max_distance() const { return max_dist_; }
+
+    /**
+     * \brief Sets the maximum distance between a referencing factor and its source
+     * 
+     * If this is smaller than the input length, each factor is the longest match whose source lies within the window
+     * of this many preceding positions.
+     * 
+     * \param max_dist the maximum distance
+     */
+    void max_distance(size_t max_dist) { max_dist_ = max_dist; }
+
+    /**
+     * \brief Reports whether referencing factors may overlap their sources
+     * 
+     * By default, overlaps are allowed.
+     * 
+     * \return \c true if no referencing factor overlaps its source
+     */
+    bool non_overlapping() const { return non_overlapping_; }
+
+    /**
+     * \brief Sets whether referencing factors may overlap their sources
+     * 
+     * If set, each factor is the longest match whose source ends before the factor begins, i.e., its length never exceeds its distance.
+     * 
+     * \param non_overlapping whether to forbid overlaps
+     */
+    void non_overlapping(bool non_overlapping) { non_overlapping_ = non_overlapping; }
+
+    /**
+     * \brief Reports on the phases of the most recent factorization
+     * 
+     * The report is only filled in if \ref report_enabled is \c true .
+     * 
+     * \return the report
+     */
+    Report const& report() const { return report_; }
+};
+
+}
+
+#endif
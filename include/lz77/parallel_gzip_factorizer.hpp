@@ -0,0 +1,193 @@
+/**
+ * lz77/parallel_gzip_factorizer.hpp
+ * part of pdinklag/lz77
+ * 
+ * MIT License
+ * 
+ * Copyright (c) Patrick Dinklage
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef _LZ77_PARALLEL_GZIP_FACTOR_HPP
+#define _LZ77_PARALLEL_GZIP_FACTOR_HPP
+
+#include <algorithm>
+#include <vector>
+
+#ifdef LIBSAIS_OPENMP
+#include <omp.h>
+#endif
+
+#include "gzip_factorizer.hpp"
+
+namespace lz77 {
+
+/**
+ * \brief Computes a gzip-style factorization of blocks of the input in parallel
+ * 
+ * Like pigz, the input is split into blocks that are factorized independently by the \ref GzipFactorizer on multiple threads.
+ * Each block's hash chains are primed with the preceding window of the input, so references may cross block boundaries,
+ * but the match search restarts at each block. The factorization therefore differs slightly from gzip's and
+ * typically has slightly more factors. The factors are emitted in input order.
+ * 
+ * Each block costs clearing the hash table and priming it with a full window, both of which grow with the window size.
+ * The blocks should therefore be considerably larger than the window, which the default block size ensures.
+ * 
+ * \tparam level the gzip compression level, from 1 to 9
+ * \tparam window_bits the base-2 logarithm of the window size, from 15 to 24
+ * \tparam Hash the hash function, \ref GzipHash by default
+ */
+template<unsigned level, unsigned window_bits = 15, GzipHashFunction Hash = GzipHash>
+class ParallelGzipFactorizer {
+private:
+    static constexpr size_t window_size_ = 1ULL << window_bits;
+    static constexpr size_t DEFAULT_BLOCK_SIZE = std::max(size_t(128 * 1024), 4 * window_size_);
+    static constexpr size_t BLOCKS_PER_THREAD = 4; // number of blocks per thread whose factors are buffered at a time
+
+    size_t block_size_;
+    size_t max_ref_len_;
+
+    Report report_;
+
+public:
+    ParallelGzipFactorizer() : block_size_(DEFAULT_BLOCK_SIZE), max_ref_len_(258) {
+    }
+
+    template<std::contiguous_iterator Input>
+    requires (sizeof(std::iter_value_t<Input>) == 1)
+    void factorize(Input begin, Input const& end, EmitFunction emit_literal, EmitFunction emit_reference) {
+        #ifdef LIBSAIS_OPENMP
+        size_t const num_threads = omp_get_max_threads();
+        #else
+        size_t const num_threads = 1;
+        #endif
+
+        report_.reset(num_threads);
+        report_.start(report_.factorization);
+
+        size_t const n = end - begin;
+        size_t const num_blocks = (n + block_size_ - 1) / block_size_;
+        size_t const blocks_per_round = num_threads * BLOCKS_PER_THREAD;
+        std::vector<std::vector<Factor>> factors(std::min(num_blocks, blocks_per_round));
+
+        #ifdef LIBSAIS_OPENMP
+        #pragma omp parallel
+        #endif
+        {
+            // each thread allocates its factorizer only once
+            GzipFactorizer<level, window_bits, Hash> gzip;
+            gzip.max_reference_length(max_ref_len_);
+
+            for(size_t round = 0; round < num_blocks; round += blocks_per_round) {
+                size_t const round_blocks = std::min(blocks_per_round, num_blocks - round);
+
+                // factorize the blocks of this round, each primed with the window preceding it
+                #ifdef LIBSAIS_OPENMP
+                #pragma omp for schedule(dynamic, 1)
+                #endif
+                for(size_t b = 0; b < round_blocks; b++) {
+                    size_t const block_begin = (round + b) * block_size_;
+                    size_t const block_end = std::min(block_begin + block_size_, n);
+                    size_t const dict_begin = block_begin - std::min(block_begin, window_size_);
+
+                    auto& block_factors = factors[b];
+                    block_factors.clear();
+                    auto emit = [&](Factor f){ block_factors.push_back(f); };
+                    gzip.factorize(begin + dict_begin, begin + block_begin, begin + block_end, emit, emit);
+                }
+
+                // emit the factors in order
+                #ifdef LIBSAIS_OPENMP
+                #pragma omp single
+                #endif
+                {
+                    for(size_t b = 0; b < round_blocks; b++) {
+                        for(auto const& f : factors[b]) {
+                            if(f.is_reference()) {
+                                emit_reference(f);
+                            } else {
+                                emit_literal(f);
+                            }
+                        }
+                    }
+                }
+            }
+        }
+
+        report_.stop();
+    }
+
+    template<std::contiguous_iterator Input, std::output_iterator<Factor> Output>
+    requires (sizeof(std::iter_value_t<Input>) == 1)
+    void factorize(Input begin, Input const& end, Output out) {
+        auto emit = [&](Factor f){ *out++ = f; };
+        factorize(begin, end, emit, emit);
+    }
+
+    /**
+     * \brief Reports the size of the blocks factorized independently
+     * 
+     * By default, this is 128 KiB as in pigz, or four times the window size if that is larger.
+     * 
+     * \return the block size
+     */
+    size_t block_size() const { return block_size_; }
+
+    /**
+     * \brief Sets the size of the blocks factorized independently
+     * 
+     * Larger blocks lose less compression at the block boundaries, but need more memory to buffer their factors
+     * and give less work to distribute among the threads. Blocks that are not considerably larger than the window
+     * spend much of their time clearing the hash table and priming it with the preceding window.
+     * 
+     * \param block_size the block size, at least one
+     */
+    void block_size(size_t block_size) { block_size_ = std::max(block_size, size_t(1)); }
+
+    /**
+     * \brief Reports the maximum length of a referencing factor
+     * 
+     * By default, this is 258 as in gzip.
+     * 
+     * \return the maximum reference length
+     */
+    size_t max_reference_length() const { return max_ref_len_; }
+
+    /**
+     * \brief Sets the maximum length of a referencing factor
+     * 
+     * \param max_ref_len the maximum reference length, clamped to the range from 3 to 258
+     * \see GzipFactorizer::max_reference_length
+     */
+    void max_reference_length(size_t max_ref_len) { max_ref_len_ = std::clamp(max_ref_len, size_t(3), size_t(258)); }
+
+    /**
+     * \brief Reports on the phases of the most recent factorization
+     * 
+     * The report is only filled in if \ref report_enabled is \c true .
+     * 
+     * \return the report
+     */
+    Report const& report() const { return report_; }
+};
+
+}
+
+#endif
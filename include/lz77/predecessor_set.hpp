@@ -0,0 +1,181 @@
+/**
+ * lz77/predecessor_set.hpp
+ * part of pdinklag/lz77
+ * 
+ * MIT License
+ * 
+ * Copyright (c) Patrick Dinklage
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef _LZ77_PREDECESSOR_SET_HPP
+#define _LZ77_PREDECESSOR_SET_HPP
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace lz77 {
+
+/**
+ * \brief A dynamic set of integers from a bounded universe supporting predecessor and successor queries
+ * 
+ * The set is represented as a tree of bit vectors with fan-out 64, where each bit on an upper level tells whether the corresponding
+ * word on the level below is non-empty. All operations take time logarithmic to base 64 in the universe size,
+ * and the set takes roughly one bit of space per universe element.
+ */
+class PredecessorSet {
+private:
+    static constexpr size_t WORD_BITS = 64;
+    static constexpr size_t WORD_SHIFT = 6;
+    static constexpr size_t WORD_MASK = WORD_BITS - 1;
+
+    std::vector<std::vector<uint64_t>> levels_;
+    size_t universe_;
+
+public:
+    /**
+     * \brief Value returned by queries that have no answer
+     */
+    static constexpr size_t NONE = SIZE_MAX;
+
+    PredecessorSet() : universe_(0) {
+    }
+
+    /**
+     * \brief Constructs an empty set over the universe <tt>[0, universe)</tt>
+     * 
+     * \param universe the universe size
+     */
+    PredecessorSet(size_t const universe) : universe_(universe) {
+        size_t size = universe;
+        do {
+            size = (size + WORD_MASK) >> WORD_SHIFT;
+            levels_.emplace_back(size, 0);
+        } while(size > 1);
+    }
+
+    /**
+     * \brief Inserts an element
+     * 
+     * \param x the element to insert
+     */
+    void insert(size_t x) {
+        for(auto& level : levels_) {
+            auto& word = level[x >> WORD_SHIFT];
+            bool const was_empty = (word == 0);
+            word |= uint64_t(1) << (x & WORD_MASK);
+            if(!was_empty) break;
+            x >>= WORD_SHIFT;
+        }
+    }
+
+    /**
+     * \brief Removes an element
+     * 
+     * \param x the element to remove
+     */
+    void erase(size_t x) {
+        for(auto& level : levels_) {
+            auto& word = level[x >> WORD_SHIFT];
+            word &= ~(uint64_t(1) << (x & WORD_MASK));
+            if(word != 0) break;
+            x >>= WORD_SHIFT;
+        }
+    }
+
+    /**
+     * \brief Tests whether an element is contained
+     * 
+     * \param x the element in question
+     * \return whether the element is contained
+     */
+    bool contains(size_t const x) const {
+        return (levels_[0][x >> WORD_SHIFT] >> (x & WORD_MASK)) & 1;
+    }
+
+    /**
+     * \brief Finds the largest contained element that is smaller than the given one
+     * 
+     * \param x the query element
+     * \return the largest contained element smaller than \c x , or \ref NONE if there is none
+     */
+    size_t predecessor(size_t x) const {
+        // go up until a level has a set bit below the query
+        size_t l = 0;
+        for(; l < levels_.size(); l++) {
+            auto const bits = x & WORD_MASK;
+            auto const word = levels_[l][x >> WORD_SHIFT] & ((uint64_t(1) << bits) - 1);
+            x >>= WORD_SHIFT;
+            if(word) {
+                x = (x << WORD_SHIFT) | (WORD_MASK - std::countl_zero(word));
+                break;
+            }
+        }
+        if(l == levels_.size()) return NONE;
+
+        // go down following the largest set bits
+        while(l > 0) {
+            --l;
+            x = (x << WORD_SHIFT) | (WORD_MASK - std::countl_zero(levels_[l][x]));
+        }
+        return x;
+    }
+
+    /**
+     * \brief Finds the smallest contained element that is greater than the given one
+     * 
+     * \param x the query element
+     * \return the smallest contained element greater than \c x , or \ref NONE if there is none
+     */
+    size_t successor(size_t x) const {
+        // go up until a level has a set bit above the query
+        size_t l = 0;
+        for(; l < levels_.size(); l++) {
+            auto const bits = x & WORD_MASK;
+            auto const word = (bits == WORD_MASK) ? 0 : levels_[l][x >> WORD_SHIFT] & (~uint64_t(0) << (bits + 1));
+            x >>= WORD_SHIFT;
+            if(word) {
+                x = (x << WORD_SHIFT) | std::countr_zero(word);
+                break;
+            }
+        }
+        if(l == levels_.size()) return NONE;
+
+        // go down following the smallest set bits
+        while(l > 0) {
+            --l;
+            x = (x << WORD_SHIFT) | std::countr_zero(levels_[l][x]);
+        }
+        return x;
+    }
+
+    /**
+     * \brief Reports the universe size
+     * 
+     * \return the universe size
+     */
+    size_t universe() const { return universe_; }
+};
+
+}
+
+#endif
@@ -0,0 +1,185 @@
+/**
+ * lz77/report.hpp
+ * part of pdinklag/lz77
+ * 
+ * MIT License
+ * 
+ * Copyright (c) Patrick Dinklage
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef _LZ77_REPORT_HPP
+#define _LZ77_REPORT_HPP
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+
+namespace lz77 {
+
+/**
+ * \brief Tells whether factorizers fill in their \ref Report
+ * 
+ * Reporting is enabled by defining \c LZ77_REPORT , e.g., via the CMake option \c LZ77_USE_REPORT .
+ * Otherwise, all reporting code is discarded at compile time.
+ */
+#ifdef LZ77_REPORT
+constexpr bool report_enabled = true;
+#else
+constexpr bool report_enabled = false;
+#endif
+
+/**
+ * \brief A structured report on the phases of a factorization
+ * 
+ * Each factorizer fills in the phases that apply to it and leaves the others zero.
+ * If \ref report_enabled is \c false , the report is never filled in.
+ */
+class Report {
+public:
+    /**
+     * \brief Measurements of a single phase
+     */
+    struct Phase {
+        /**
+         * \brief The wall time spent in the phase, in nanoseconds
+         */
+        uintmax_t nanoseconds = 0;
+
+        /**
+         * \brief The peak number of bytes allocated by the factorizer during the phase
+         */
+        uintmax_t peak_bytes = 0;
+    };
+
+    /**
+     * \brief Suffix array construction
+     */
+    Phase suffix_array;
+
+    /**
+     * \brief Inversion of the suffix array, or construction of the auxiliary array of smaller values
+     */
+    Phase inverse;
+
+    /**
+     * \brief The factorization loop
+     */
+    Phase factorization;
+
+    /**
+     * \brief Sliding the window and rebasing the hash chains (gzip only)
+     */
+    Phase slide;
+
+    /**
+     * \brief The number of character comparisons performed for longest common extensions
+     */
+    uintmax_t lce_comparisons = 0;
+
+    /**
+     * \brief The number of threads used
+     */
+    unsigned num_threads = 1;
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    Phase* current_ = nullptr;
+    Clock::time_point start_;
+    uintmax_t live_bytes_ = 0;
+
+public:
+    /**
+     * \brief Resets all measurements
+     * 
+     * \param num_threads the number of threads that will be used
+     */
+    void reset(unsigned const num_threads) {
+        if constexpr(report_enabled) {
+            *this = Report();
+            this->num_threads = num_threads;
+        }
+    }
+
+    /**
+     * \brief Stops measuring the current phase, if any, and starts measuring the given phase
+     * 
+     * \param phase the phase to measure
+     */
+    void start(Phase& phase) {
+        if constexpr(report_enabled) {
+            stop();
+            current_ = &phase;
+            current_->peak_bytes = std::max(current_->peak_bytes, live_bytes_);
+            start_ = Clock::now();
+        }
+    }
+
+    /**
+     * \brief Stops measuring the current phase, if any
+     */
+    void stop() {
+        if constexpr(report_enabled) {
+            if(current_) {
+                current_->nanoseconds += std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start_).count();
+                current_ = nullptr;
+            }
+        }
+    }
+
+    /**
+     * \brief Records an allocation
+     * 
+     * \param bytes the number of allocated bytes
+     */
+    void allocate(uintmax_t const bytes) {
+        if constexpr(report_enabled) {
+            live_bytes_ += bytes;
+            if(current_) current_->peak_bytes = std::max(current_->peak_bytes, live_bytes_);
+        }
+    }
+
+    /**
+     * \brief Records a deallocation
+     * 
+     * \param bytes the number of deallocated bytes
+     */
+    void deallocate(uintmax_t const bytes) {
+        if constexpr(report_enabled) {
+            live_bytes_ -= bytes;
+        }
+    }
+
+    /**
+     * \brief Records character comparisons for a longest common extension
+     * 
+     * \param num the number of comparisons
+     */
+    void compared(uintmax_t const num) {
+        if constexpr(report_enabled) {
+            lce_comparisons += num;
+        }
+    }
+};
+
+}
+
+#endif
@@ -0,0 +1,447 @@
+/**
+ * lz77/sparse_factorizer.hpp
+ * part of pdinklag/lz77
+ * 
+ * MIT License
+ * 
+ * Copyright (c) Patrick Dinklage
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef _LZ77_SPARSE_FACTORIZER_HPP
+#define _LZ77_SPARSE_FACTORIZER_HPP
+
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <span>
+#include <type_traits>
+
+#ifdef LIBSAIS_OPENMP
+#include <omp.h>
+#endif
+
+#include "allocation.hpp"
+#include "emit_function.hpp"
+#include "report.hpp"
+#include "suffix_array.hpp"
+
+namespace lz77 {
+
+/**
+ * \brief Computes the greedy Lempel-Ziv 77 factorization with a large minimum reference length using a sparse suffix array
+ * 
+ * For a minimum reference length \c k, only the suffixes starting at every <tt>s = ceil(k/2)</tt>-th text position are sorted.
+ * Any previous occurrence of length at least \c k contains such a sampled position within its first \c s characters,
+ * from which it matches the corresponding suffix of the current position for at least <tt>h = floor(k/2)+1</tt> characters.
+ * Hence, for each of the \c s offsets from the current position, the candidates are found among the sampled suffixes sharing
+ * the \c h -prefix of the shifted position. These groups are looked up in a hash table, searched for the position's rank and
+ * walked outwards using the sparse LCP array, and each candidate is verified by comparing the skipped characters backwards.
+ * 
+ * The sparse suffix array is constructed by sorting the blocks of \c s characters and computing the suffix array of the
+ * resulting string of block ranks. Along with the sparse LCP array and the hash table of groups, this takes at most
+ * <tt>7n/s</tt> words rather than the several words per character taken by the other suffix array based factorizers.
+ * 
+ * The factors have the same lengths as in the exact greedy factorization with the same minimum reference length,
+ * but if multiple sources are eligible for a factor, any of them may be chosen.
+ * 
+ * The input may consist of bytes or of 16-bit or 32-bit integer symbols (see \ref Symbol ).
+ */
+class SparseFactorizer {
+private:
+    static constexpr size_t MAX_SIZE_32BIT = 1ULL << 31;
+    static constexpr size_t DEFAULT_MIN_REF_LEN = 32;
+
+    // multiplier of the rolling fingerprints of the h-prefixes
+    static constexpr uint64_t FINGERPRINT_BASE = 0x100000001B3ULL;
+
+    size_t min_ref_len_;
+    size_t max_ref_len_;
+    size_t max_dist_;
+    AllocationPolicy alloc_;
+    Report report_;
+
+    template<bool require_64bit, typename Char>
+    void factorize(std::span<Char const> const& t, EmitFunction emit_literal, EmitFunction emit_reference) {
+        using Index = std::conditional_t<require_64bit, uint64_t, uint32_t>;
+        using SignedIndex = std::make_signed_t<Index>;
+        using Unsigned = std::make_unsigned_t<Char>;
+
+        size_t const n = t.size();
+        size_t const k = std::max(min_ref_len_, size_t(1));
+        size_t const s = (k + 1) / 2; // sampling rate
+        size_t const h = k / 2 + 1;   // guaranteed match length from a sampled position, i.e., k - s + 1
+        size_t const m = (n + s - 1) / s;
+
+        // symbols are compared as unsigned values, consistent with the block ranks
+        auto sym = [&](size_t const x){ return Unsigned(t[x]); };
+        auto lce = [&](size_t const i, size_t const j, size_t const l0, size_t const max = SIZE_MAX){
+            size_t l = l0;
+            while(l < max && i + l < n && j + l < n && t[i + l] == t[j + l]) ++l;
+            report_.compared(l - l0 + (l < max && i + l < n && j + l < n));
+            return l;
+        };
+
+        // sort the blocks of s symbols and rename them by their ranks
+        // the last block may be shorter and is then smaller than any block it is a prefix of, which is consistent with suffix order
+        report_.start(report_.suffix_array);
+        auto sa = allocate_for_overwrite<Index>(m, alloc_);
+        report_.allocate(m * sizeof(Index));
+        auto aux = allocate_for_overwrite<SignedIndex>(m, alloc_);
+        report_.allocate(m * sizeof(SignedIndex));
+
+        auto block_less = [&](size_t const a, size_t const b){
+            size_t const pa = a * s, pb = b * s;
+            size_t const la = std::min(s, n - pa), lb = std::min(s, n - pb);
+            for(size_t x = 0; x < std::min(la, lb); x++) {
+                if(sym(pa + x) != sym(pb + x)) return sym(pa + x) < sym(pb + x);
+            }
+            return la < lb;
+        };
+
+        for(size_t x = 0; x < m; x++) sa[x] = x;
+        std::sort(sa.get(), sa.get() + m, block_less);
+
+        SignedIndex sigma = 0;
+        for(size_t r = 0; r < m; r++) {
+            if(r > 0 && block_less(sa[r - 1], sa[r])) ++sigma;
+            aux[sa[r]] = sigma;
+        }
+        ++sigma;
+
+        // sort the suffixes of the string of block ranks, which yields the sampled suffixes in lexicographic order
+        if constexpr(require_64bit) {
+            #ifdef LIBSAIS_OPENMP
+            libsais64_long_omp((int64_t*)aux.get(), (int64_t*)sa.get(), m, sigma, 0, omp_get_max_threads());
+            #else
+            libsais64_long((int64_t*)aux.get(), (int64_t*)sa.get(), m, sigma, 0);
+            #endif
+        } else {
+            #ifdef LIBSAIS_OPENMP
+            libsais_int_omp((int32_t*)aux.get(), (int32_t*)sa.get(), m, sigma, 0, omp_get_max_threads());
+            #else
+            libsais_int((int32_t*)aux.get(), (int32_t*)sa.get(), m, sigma, 0);
+            #endif
+        }
+
+        // compute the sparse PLCP array using the Phi method, exploiting that the LCP decreases by at most s from one sample to the next
+        report_.start(report_.inverse);
+        auto& plcp = aux;
+        {
+            if(m > 0) plcp[sa[0]] = -1;
+            for(size_t r = 1; r < m; r++) plcp[sa[r]] = sa[r - 1];
+
+            size_t l = 0;
+            for(size_t x = 0; x < m; x++) {
+                if(plcp[x] < 0) {
+                    plcp[x] = 0;
+                    l = 0;
+                } else {
+                    l = lce(x * s, size_t(plcp[x]) * s, l);
+                    plcp[x] = l;
+                    l = (l > s) ? l - s : 0;
+                }
+            }
+        }
+
+        // enumerate the groups of sampled suffixes sharing an h-prefix by their first ranks and leftmost samples,
+        // and fill a hash table with them
+        auto fingerprint = [&](size_t const p){
+            uint64_t f = 0;
+            for(size_t x = 0; x < h; x++) f = f * FINGERPRINT_BASE + sym(p + x) + 1;
+            return f;
+        };
+
+        auto starts_group = [&](size_t const r){
+            return n - sa[r] * s >= h && (r == 0 || size_t(plcp[sa[r]]) < h);
+        };
+
+        size_t num_groups = 0;
+        for(size_t r = 0; r < m; r++) num_groups += starts_group(r);
+
+        auto groups = allocate_for_overwrite<Index>(num_groups + 1, alloc_);
+        auto leftmost = allocate_for_overwrite<Index>(num_groups, alloc_);
+        report_.allocate((2 * num_groups + 1) * sizeof(Index));
+        {
+            size_t id = 0;
+            for(size_t r = 0; r < m; r++) {
+                if(starts_group(r)) {
+                    groups[id] = r;
+                    leftmost[id] = sa[r];
+                    ++id;
+                } else if(id > 0) {
+                    leftmost[id - 1] = std::min(leftmost[id - 1], sa[r]);
+                }
+            }
+            groups[num_groups] = m;
+        }
+
+        size_t const table_size = std::bit_ceil(num_groups + num_groups / 2 + 2);
+        size_t const table_bits = std::countr_zero(table_size);
+        constexpr Index EMPTY = std::numeric_limits<Index>::max();
+        auto table = allocate_for_overwrite<Index>(table_size, alloc_);
+        report_.allocate(table_size * sizeof(Index));
+        std::fill(table.get(), table.get() + table_size, EMPTY);
+
+        auto slot = [&](uint64_t const f){ return size_t((f * 0x9E3779B97F4A7C15ULL) >> (64 - table_bits)); };
+        for(size_t id = 0; id < num_groups; id++) {
+            size_t x = slot(fingerprint(sa[groups[id]] * s));
+            while(table[x] != EMPTY) x = (x + 1) & (table_size - 1);
+            table[x] = id;
+        }
+
+        // finds the group sharing the h-prefix of position q, or EMPTY if there is none
+        auto find_group = [&](size_t const q, uint64_t const f) -> Index {
+            for(size_t x = slot(f); table[x] != EMPTY; x = (x + 1) & (table_size - 1)) {
+                if(lce(q, sa[groups[table[x]]] * s, 0, h) == h) return table[x];
+            }
+            return EMPTY;
+        };
+
+        // factorize
+        report_.start(report_.factorization);
+
+        // rolling fingerprints of the h-prefixes of the s positions following the current one
+        auto fingerprints = std::make_unique<uint64_t[]>(s);
+        report_.allocate(s * sizeof(uint64_t));
+        uint64_t const base_pow = [&](){ uint64_t b = 1; for(size_t x = 1; x < h; x++) b *= FINGERPRINT_BASE; return b; }();
+        uint64_t f = 0;
+        size_t fingerprints_end = 0;
+
+        for(size_t i = 0; i < n;) {
+            size_t max_len = 0, max_src = 0;
+            if(i + k <= n) {
+                // compute the fingerprints of the positions up to i + num_offsets
+                size_t const num_offsets = std::min(s, n - h - i + 1);
+                while(fingerprints_end < i + num_offsets) {
+                    if(fingerprints_end == 0) {
+                        f = fingerprint(0);
+                    } else {
+                        size_t const q = fingerprints_end - 1;
+                        f = (f - (uint64_t(sym(q)) + 1) * base_pow) * FINGERPRINT_BASE + sym(q + h) + 1;
+                    }
+                    fingerprints[fingerprints_end % s] = f;
+                    ++fingerprints_end;
+                }
+
+                for(size_t o = 0; o < num_offsets; o++) {
+                    size_t const q = i + o;
+                    // skip the offset if no sample sharing the h-prefix precedes q,
+                    // which avoids comparing novel content against its later repetitions
+                    size_t const id = find_group(q, fingerprints[q % s]);
+                    if(id == EMPTY || leftmost[id] * s >= q) continue;
+
+                    // the group spans the ranks up to the next group, except for the at most two samples shorter than h before it
+                    size_t const g = groups[id];
+                    size_t e = groups[id + 1];
+                    while(n - sa[e - 1] * s < h) --e;
+
+                    // find the rank r of suffix q among the samples by binary search within the group,
+                    // tracking the LCPs with both boundaries to skip characters known to match
+                    size_t lo = g, hi = e;
+                    size_t lo_lcp = h, hi_lcp = h;
+                    while(lo < hi) {
+                        size_t const mid = lo + (hi - lo) / 2;
+                        size_t const p = sa[mid] * s;
+                        if(p == q) {
+                            // q is a sample itself and thus its own rank
+                            hi = mid;
+                            hi_lcp = n - q;
+                            continue;
+                        }
+
+                        size_t const l = lce(p, q, std::min(lo_lcp, hi_lcp));
+                        if(q + l < n && (p + l == n || sym(p + l) < sym(q + l))) {
+                            lo = mid + 1;
+                            lo_lcp = l;
+                        } else {
+                            hi = mid;
+                            hi_lcp = l;
+                        }
+                    }
+                    size_t const r = lo;
+
+                    // considers the sampled position p as the source for offset o, given that it matches suffix q for l characters
+                    // the walks stop as soon as the candidate length cannot exceed the current maximum or the minimum reference length
+                    auto consider = [&](size_t const p, size_t const l){
+                        size_t const len = std::min(o + l, max_ref_len_);
+                        if(len <= std::max(max_len, k - 1)) return false;
+
+                        if(p < q && p >= o && i - (p - o) <= max_dist_ && lce(p - o, i, 0, o) == o) {
+                            max_len = len;
+                            max_src = i - (p - o);
+                        }
+                        return true;
+                    };
+
+                    // walk towards lexicographically smaller samples
+                    if(r > g) {
+                        size_t l = lo_lcp;
+                        for(size_t x = r; x > g; x--) {
+                            if(x < r) l = std::min(l, size_t(plcp[sa[x]]));
+                            if(!consider(sa[x - 1] * s, l)) break;
+                        }
+                    }
+
+                    // walk towards lexicographically greater samples
+                    if(r < e) {
+                        size_t l = hi_lcp;
+                        for(size_t x = r; x < e; x++) {
+                            if(x > r) l = std::min(l, size_t(plcp[sa[x]]));
+                            if(!consider(sa[x] * s, l)) break;
+                        }
+                    }
+                }
+            }
+
+            if(max_len > 0) {
+                // emit reference
+                emit_reference(Factor(max_src, max_len));
+                i += max_len; //advance
+            } else {
+                // emit literal
+                emit_literal(Factor(t[i]));
+                ++i; //advance
+            }
+        }
+
+        report_.deallocate((2 * m + 2 * num_groups + 1 + table_size) * sizeof(Index) + s * sizeof(uint64_t));
+        report_.stop();
+    }
+
+public:
+    SparseFactorizer() : min_ref_len_(DEFAULT_MIN_REF_LEN), max_ref_len_(SIZE_MAX), max_dist_(SIZE_MAX) {
+    }
+
+    template<std::contiguous_iterator Input>
+    requires Symbol<std::iter_value_t<Input>>
+    void factorize(Input begin, Input const& end, EmitFunction emit_literal, EmitFunction emit_reference) {
+        std::span<std::iter_value_t<Input> const> const t(std::to_address(begin), end - begin);
+
+        #ifdef LIBSAIS_OPENMP
+        report_.reset(omp_get_max_threads());
+        #else
+        report_.reset(1);
+        #endif
+
+        if(t.size() < MAX_SIZE_32BIT) {
+            factorize<false>(t, emit_literal, emit_reference);
+        } else {
+            factorize<true>(t, emit_literal, emit_reference);
+        }
+    }
+
+    template<std::contiguous_iterator Input, std::output_iterator<Factor> Output>
+    requires Symbol<std::iter_value_t<Input>>
+    void factorize(Input begin, Input const& end, Output out) {
+        auto emit = [&](Factor f){ *out++ = f; };
+        factorize(begin, end, emit, emit);
+    }
+
+    /**
+     * \brief Reports the minimum length of a referencing factor
+     * 
+     * If a referencing factor is shorter than this length, a literal factor is emitted instead.
+     * By default, the length is 32.
+     * 
+     * \return the minimum reference length
+     */
+    size_t min_reference_length() const { return min_ref_len_; }
+
+    /**
+     * \brief Sets the minimum length of a referencing factor
+     * 
+     * If a referencing factor is shorter than this length, a literal factor is emitted instead.
+     * The suffix array is sampled at every <tt>ceil(min_ref_len/2)</tt>-th position, so larger lengths save more memory.
+     * 
+     * \param min_ref_len the minimum reference length
+     */
+    void min_reference_length(size_t min_ref_len) { min_ref_len_ = min_ref_len; }
+
+    /**
+     * \brief Reports the maximum length of a referencing factor
+     * 
+     * By default, the length is unbounded.
+     * 
+     * \return the maximum reference length
+     */
+    size_t max_reference_length() const { return max_ref_len_; }
+
+    /**
+     * \brief Sets the maximum length of a referencing factor
+     * 
+     * Longer matches are not split afterwards, but the factorization continues greedily with a fresh source after this many characters.
+     * 
+     * \param max_ref_len the maximum reference length
+     */
+    void max_reference_length(size_t max_ref_len) { max_ref_len_ = max_ref_len; }
+
+    /**
+     * \brief Reports the maximum distance between a referencing factor and its source
+     * 
+     * By default, the distance is unbounded.
+     * 
+     * \return the maximum distance
+     */
+    size_t max_distance() const { return max_dist_; }
+
+    /**
+     * \brief Sets the maximum distance between a referencing factor and its source
+     * 
+     * If this is smaller than the input length, each factor is the longest match whose source lies within the window
+     * of this many preceding positions.
+     * 
+     * \param max_dist the maximum distance
+     */
+    void max_distance(size_t max_dist) { max_dist_ = max_dist; }
+
+    /**
+     * \brief Reports the policy used to allocate the sparse suffix array and the arrays derived from it
+     * 
+     * \return the allocation policy
+     */
+    AllocationPolicy const& allocation_policy() const { return alloc_; }
+
+    /**
+     * \brief Sets the policy used to allocate the sparse suffix array and the arrays derived from it
+     * 
+     * \param policy the allocation policy
+     */
+    void allocation_policy(AllocationPolicy const& policy) { alloc_ = policy; }
+
+    /**
+     * \brief Reports on the phases of the most recent factorization
+     * 
+     * The report is only filled in if \ref report_enabled is \c true .
+     * 
+     * \return the report
+     */
+    Report const& report() const { return report_; }
+};
+
+}
+
+#endif
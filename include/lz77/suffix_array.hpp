@@ -0,0 +1,226 @@
+/**
+ * lz77/suffix_array.hpp
+ * part of pdinklag/lz77
+ * 
+ * MIT License
+ * 
+ * Copyright (c) Patrick Dinklage
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef _LZ77_SUFFIX_ARRAY_HPP
+#define _LZ77_SUFFIX_ARRAY_HPP
+
+#include <algorithm>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+#include <libsais.h>
+#include <libsais16.h>
+#include <libsais16x64.h>
+#include <libsais64.h>
+
+#ifdef LIBSAIS_OPENMP
+#include <omp.h>
+#endif
+
+#include "report.hpp"
+
+namespace lz77 {
+
+/**
+ * \brief Concept for the symbol types supported by the suffix array based factorizers
+ * 
+ * Symbols may be bytes, or 16-bit or 32-bit integers for inputs over large alphabets (e.g., token streams).
+ */
+template<typename Char>
+concept Symbol = std::integral<Char> && (sizeof(Char) == 1 || sizeof(Char) == 2 || sizeof(Char) == 4);
+
+/**
+ * \brief Constructs the suffix array of a text using libsais
+ * 
+ * Byte and 16-bit texts are passed to libsais directly.
+ * 32-bit texts are copied into an integer array as required by libsais for integer alphabets.
+ * If the largest symbol is not smaller than the text length, the alphabet is reduced to the distinct symbols occurring in the text.
+ * 
+ * \tparam Index the suffix array entry type, either 32 or 64 bits wide
+ * \param t the text
+ * \param sa the output suffix array, must have room for \c t.size() entries
+ * \param report the report to record temporary allocations in
+ */
+template<std::unsigned_integral Index, Symbol Char>
+requires (sizeof(Index) == 4 || sizeof(Index) == 8)
+void suffix_array(std::span<Char const> const t, Index* sa, Report& report) {
+    using SignedIndex = std::make_signed_t<Index>;
+    constexpr bool require_64bit = sizeof(Index) == 8;
+
+    SignedIndex const n = t.size();
+    if constexpr(sizeof(Char) == 1) {
+        auto const* text = (uint8_t const*)t.data();
+        if constexpr(require_64bit) {
+            #ifdef LIBSAIS_OPENMP
+            libsais64_omp(text, (int64_t*)sa, n, 0, nullptr, omp_get_max_threads());
+            #else
+            libsais64(text, (int64_t*)sa, n, 0, nullptr);
+            #endif
+        } else {
+            #ifdef LIBSAIS_OPENMP
+            libsais_omp(text, (int32_t*)sa, n, 0, nullptr, omp_get_max_threads());
+            #else
+            libsais(text, (int32_t*)sa, n, 0, nullptr);
+            #endif
+        }
+    } else if constexpr(sizeof(Char) == 2) {
+        auto const* text = (uint16_t const*)t.data();
+        if constexpr(require_64bit) {
+            #ifdef LIBSAIS_OPENMP
+            libsais16x64_omp(text, (int64_t*)sa, n, 0, nullptr, omp_get_max_threads());
+            #else
+            libsais16x64(text, (int64_t*)sa, n, 0, nullptr);
+            #endif
+        } else {
+            #ifdef LIBSAIS_OPENMP
+            libsais16_omp(text, (int32_t*)sa, n, 0, nullptr, omp_get_max_threads());
+            #else
+            libsais16(text, (int32_t*)sa, n, 0, nullptr);
+            #endif
+        }
+    } else {
+        // libsais requires a mutable integer text over the alphabet [0, k)
+        auto const* u = (uint32_t const*)t.data();
+        auto text = std::make_unique<SignedIndex[]>(n);
+        report.allocate(n * sizeof(SignedIndex));
+
+        SignedIndex k;
+        uint32_t const max = n > 0 ? *std::max_element(u, u + n) : 0;
+        if(uintmax_t(max) < uintmax_t(n)) {
+            std::copy(u, u + n, text.get());
+            k = SignedIndex(max) + 1;
+        } else {
+            // reduce alphabet
+            std::vector<uint32_t> alphabet(u, u + n);
+            report.allocate(n * sizeof(uint32_t));
+            std::sort(alphabet.begin(), alphabet.end());
+            alphabet.erase(std::unique(alphabet.begin(), alphabet.end()), alphabet.end());
+
+            for(SignedIndex i = 0; i < n; i++) {
+                text[i] = std::lower_bound(alphabet.begin(), alphabet.end(), u[i]) - alphabet.begin();
+            }
+            k = alphabet.size();
+            report.deallocate(n * sizeof(uint32_t));
+        }
+
+        if constexpr(require_64bit) {
+            #ifdef LIBSAIS_OPENMP
+            libsais64_long_omp((int64_t*)text.get(), (int64_t*)sa, n, k, 0, omp_get_max_threads());
+            #else
+            libsais64_long((int64_t*)text.get(), (int64_t*)sa, n, k, 0);
+            #endif
+        } else {
+            #ifdef LIBSAIS_OPENMP
+            libsais_int_omp((int32_t*)text.get(), (int32_t*)sa, n, k, 0, omp_get_max_threads());
+            #else
+            libsais_int((int32_t*)text.get(), (int32_t*)sa, n, k, 0);
+            #endif
+        }
+        report.deallocate(n * sizeof(SignedIndex));
+    }
+}
+
+/**
+ * \brief Constructs the permuted longest common prefix (PLCP) array of a text using libsais
+ * 
+ * The entry for text position \c i is the length of the longest common prefix of suffix \c i and its predecessor in the suffix array,
+ * or zero for the lexicographically smallest suffix.
+ * Byte and 16-bit texts are passed to libsais directly.
+ * For 32-bit texts, the array is computed using the Phi method by Kärkkäinen, Manzini and Puglisi [CPM 2009].
+ * 
+ * \tparam Index the array entry type, either 32 or 64 bits wide
+ * \param t the text
+ * \param sa the suffix array of the text
+ * \param plcp the output PLCP array, must have room for \c t.size() entries
+ * \param report the report to record character comparisons in
+ */
+template<std::unsigned_integral Index, Symbol Char>
+requires (sizeof(Index) == 4 || sizeof(Index) == 8)
+void plcp_array(std::span<Char const> const t, Index const* sa, Index* plcp, Report& report) {
+    constexpr bool require_64bit = sizeof(Index) == 8;
+
+    Index const n = t.size();
+    if constexpr(sizeof(Char) == 1) {
+        auto const* text = (uint8_t const*)t.data();
+        if constexpr(require_64bit) {
+            #ifdef LIBSAIS_OPENMP
+            libsais64_plcp_omp(text, (int64_t const*)sa, (int64_t*)plcp, n, omp_get_max_threads());
+            #else
+            libsais64_plcp(text, (int64_t const*)sa, (int64_t*)plcp, n);
+            #endif
+        } else {
+            #ifdef LIBSAIS_OPENMP
+            libsais_plcp_omp(text, (int32_t const*)sa, (int32_t*)plcp, n, omp_get_max_threads());
+            #else
+            libsais_plcp(text, (int32_t const*)sa, (int32_t*)plcp, n);
+            #endif
+        }
+    } else if constexpr(sizeof(Char) == 2) {
+        auto const* text = (uint16_t const*)t.data();
+        if constexpr(require_64bit) {
+            #ifdef LIBSAIS_OPENMP
+            libsais16x64_plcp_omp(text, (int64_t const*)sa, (int64_t*)plcp, n, omp_get_max_threads());
+            #else
+            libsais16x64_plcp(text, (int64_t const*)sa, (int64_t*)plcp, n);
+            #endif
+        } else {
+            #ifdef LIBSAIS_OPENMP
+            libsais16_plcp_omp(text, (int32_t const*)sa, (int32_t*)plcp, n, omp_get_max_threads());
+            #else
+            libsais16_plcp(text, (int32_t const*)sa, (int32_t*)plcp, n);
+            #endif
+        }
+    } else {
+        // compute Phi array in place, then overwrite it with the PLCP values in text order
+        Index const none = n;
+        if(n > 0) plcp[sa[0]] = none;
+        for(Index k = 1; k < n; k++) plcp[sa[k]] = sa[k-1];
+
+        Index l = 0;
+        for(Index i = 0; i < n; i++) {
+            Index const j = plcp[i];
+            if(j == none) {
+                l = 0;
+            } else {
+                Index const l0 = l;
+                while(i + l < n && j + l < n && t[i + l] == t[j + l]) ++l;
+                report.compared(l - l0 + (i + l < n && j + l < n));
+            }
+            plcp[i] = l;
+            if(l > 0) --l;
+        }
+    }
+}
+
+}
+
+#endif
@@ -0,0 +1,57 @@
+/**
+ * lz77/uint40.hpp
+ * part of pdinklag/lz77
+ * 
+ * MIT License
+ * 
+ * Copyright (c) Patrick Dinklage
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef _LZ77_UINT40_HPP
+#define _LZ77_UINT40_HPP
+
+#include <cstdint>
+
+namespace lz77 {
+
+/**
+ * \brief A packed 40-bit unsigned integer
+ * 
+ * Arrays of this type take five bytes per entry, which suffices for inputs of up to one terabyte.
+ * Values are converted implicitly from and to \c uint64_t .
+ */
+class __attribute__((packed)) uint40_t {
+private:
+    uint32_t low_;
+    uint8_t high_;
+
+public:
+    uint40_t() = default;
+    constexpr uint40_t(uint64_t const v) : low_(uint32_t(v)), high_(uint8_t(v >> 32)) {}
+
+    constexpr operator uint64_t() const { return (uint64_t(high_) << 32) | low_; }
+};
+
+static_assert(sizeof(uint40_t) == 5);
+
+}
+
+#endif
@@ -0,0 +1,230 @@
+/**
+ * lz77/window_engine.hpp
+ * part of pdinklag/lz77
+ * 
+ * MIT License
+ * 
+ * Copyright (c) Patrick Dinklage
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef _LZ77_WINDOW_ENGINE_HPP
+#define _LZ77_WINDOW_ENGINE_HPP
+
+#include <algorithm>
+#include <cassert>
+#include <concepts>
+#include <cstddef>
+#include <span>
+
+#include "allocation.hpp"
+#include "emit_function.hpp"
+#include "inverse_suffix_array.hpp"
+#include "predecessor_set.hpp"
+#include "report.hpp"
+#include "suffix_array.hpp"
+
+namespace lz77::internal {
+
+template<typename Char>
+size_t lce(std::span<Char const> const& t, size_t const i, size_t const j, size_t const max, Report& report) {
+    auto const n = t.size();
+
+    size_t l = 0;
+    while(l < max && i + l < n && j + l < n && t[i + l] == t[j + l]) ++l;
+
+    report.compared(l + (l < max && i + l < n && j + l < n));
+    return l;
+}
+
+// computes the greedy factorization with sources restricted to the max_distance preceding positions
+// the longest match within the window is either the lexicographic predecessor or successor of the current suffix among the window,
+// which are found by maintaining the suffix array ranks of the window positions in a predecessor set
+// ties are broken like in the unbounded factorizers, i.e., preferring the predecessor
+// match lengths are capped at max_ref_len before breaking ties
+template<std::unsigned_integral Index, Symbol Char>
+void factorize_window(
+    std::span<Char const> const& t,
+    size_t const min_ref_len,
+    size_t const max_ref_len,
+    size_t const max_distance,
+    AllocationPolicy const& alloc,
+    Report& report,
+    EmitFunction emit_literal,
+    EmitFunction emit_reference) {
+
+    // construct suffix array and its inverse
+    Index const n = t.size();
+    report.start(report.suffix_array);
+    auto sa = allocate<Index>(n, alloc);
+    report.allocate(n * sizeof(Index));
+    suffix_array(t, sa.get(), report);
+
+    report.start(report.inverse);
+    auto isa = allocate_for_overwrite<Index>(n, alloc);
+    report.allocate(n * sizeof(Index));
+    inverse_suffix_array<Index>(sa.get(), isa.get(), n, report, alloc);
+
+    // factorize
+    report.start(report.factorization);
+    PredecessorSet window(n);
+    report.allocate(n / 8);
+
+    size_t window_begin = 0, window_end = 0;
+    for(size_t i = 0; i < n;) {
+        // slide window to [i - max_distance, i)
+        while(window_end < i) window.insert(isa[window_end++]);
+        while(window_begin + max_distance < i) window.erase(isa[window_begin++]);
+
+        // find lexicographic neighbours within window
+        auto const pred = window.predecessor(isa[i]);
+        auto const succ = window.successor(isa[i]);
+        size_t const psv_lcp = pred != PredecessorSet::NONE ? lce(t, i, (size_t)sa[pred], max_ref_len, report) : 0;
+        size_t const nsv_lcp = succ != PredecessorSet::NONE ? lce(t, i, (size_t)sa[succ], max_ref_len, report) : 0;
+
+        //select maximum
+        size_t const max_lcp = std::max(psv_lcp, nsv_lcp);
+        if(max_lcp > 0 && max_lcp >= min_ref_len) {
+            size_t const max_pos = (max_lcp == psv_lcp) ? sa[pred] : sa[succ];
+            assert(max_pos < i);
+            assert(i - max_pos <= max_distance);
+
+            // emit reference
+            emit_reference(Factor(i - max_pos, max_lcp));
+            i += max_lcp; //advance
+        } else {
+            // emit literal
+            emit_literal(Factor(t[i]));
+            ++i; //advance
+        }
+    }
+
+    report.deallocate(2 * n * sizeof(Index) + n / 8);
+    report.stop();
+}
+
+// computes the greedy factorization in which no reference overlaps its own source, i.e., the distance is at least the length
+// candidate sources are visited in suffix array order, walking outwards from the current suffix while maintaining the running minimum
+// of the LCP array; each walk stops as soon as that minimum can no longer improve the best candidate found so far
+// among the longest candidates, the predecessor side is preferred and, within a side, the lexicographically closest one
+// the max_distance and max_ref_len restrictions are applied to every candidate
+// the walks also pass over suffixes that start at or after the current position, which can never be sources,
+// so a single walk may take O(n) steps and the factorization takes O(nz) time for z factors in the worst case;
+// this happens on periodic texts, e.g., about n^1.5 steps on concatenations of the runs a^k b for growing k
+template<std::unsigned_integral Index, Symbol Char>
+void factorize_non_overlapping(
+    std::span<Char const> const& t,
+    size_t const min_ref_len,
+    size_t const max_ref_len,
+    size_t const max_distance,
+    AllocationPolicy const& alloc,
+    Report& report,
+    EmitFunction emit_literal,
+    EmitFunction emit_reference) {
+
+    // construct suffix array
+    Index const n = t.size();
+    report.start(report.suffix_array);
+    auto sa = allocate<Index>(n, alloc);
+    report.allocate(n * sizeof(Index));
+    suffix_array(t, sa.get(), report);
+
+    // construct LCP array via the PLCP array, then reuse the PLCP array for the inverse suffix array
+    report.start(report.inverse);
+    auto isa = allocate<Index>(n, alloc);
+    report.allocate(n * sizeof(Index));
+    plcp_array(t, (Index const*)sa.get(), isa.get(), report);
+
+    auto lcp = allocate_for_overwrite<Index>(n, alloc);
+    report.allocate(n * sizeof(Index));
+    {
+        #ifdef LIBSAIS_OPENMP
+        #pragma omp parallel for
+        #endif
+        for(size_t k = 0; k < n; k++) lcp[k] = isa[sa[k]];
+    }
+    inverse_suffix_array<Index>(sa.get(), isa.get(), n, report, alloc);
+
+    // factorize
+    report.start(report.factorization);
+    for(size_t i = 0; i < n;) {
+        size_t const r = isa[i];
+
+        // walk towards lexicographically smaller suffixes
+        size_t psv = n, psv_len = 0;
+        {
+            size_t h = max_ref_len;
+            for(size_t k = r; k > 0; k--) {
+                h = std::min(h, (size_t)lcp[k]);
+                if(h <= psv_len) break;
+
+                size_t const j = sa[k - 1];
+                if(j < i && i - j <= max_distance) {
+                    size_t const len = std::min(h, i - j);
+                    if(len > psv_len) {
+                        psv = j;
+                        psv_len = len;
+                    }
+                }
+            }
+        }
+
+        // walk towards lexicographically greater suffixes, which only need to be considered if they beat the predecessor side
+        size_t nsv = n, nsv_len = 0;
+        {
+            size_t h = max_ref_len;
+            for(size_t k = r + 1; k < n; k++) {
+                h = std::min(h, (size_t)lcp[k]);
+                if(h <= std::max(psv_len, nsv_len)) break;
+
+                size_t const j = sa[k];
+                if(j < i && i - j <= max_distance) {
+                    size_t const len = std::min(h, i - j);
+                    if(len > nsv_len) {
+                        nsv = j;
+                        nsv_len = len;
+                    }
+                }
+            }
+        }
+
+        //select maximum
+        size_t const max_len = std::max(psv_len, nsv_len);
+        if(max_len > 0 && max_len >= min_ref_len) {
+            size_t const max_pos = (nsv_len > psv_len) ? nsv : psv;
+            assert(max_pos + max_len <= i);
+
+            // emit reference
+            emit_reference(Factor(i - max_pos, max_len));
+            i += max_len; //advance
+        } else {
+            // emit literal
+            emit_literal(Factor(t[i]));
+            ++i; //advance
+        }
+    }
+
+    report.deallocate(3 * n * sizeof(Index));
+    report.stop();
+}
+
+}
+
+#endif
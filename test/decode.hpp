@@ -28,26 +28,37 @@
 #include <cassert>
 #include <concepts>
 #include <iterator>
+#include <string>
 #include <lz77/factor.hpp>
 
 namespace lz77::test {
 
-template<std::input_iterator It>
+template<typename String = std::string, std::input_iterator It>
 requires std::same_as<std::iter_value_t<It>, Factor>
-std::string decode(It begin, It const end) {
-    std::string dec;
+String decode(It begin, It const end) {
+    String dec;
     while(begin != end) {
         auto const f = *begin++;
         if(f.is_reference()) {
-            auto const src = dec.length() - f.src;
+            auto const src = dec.size() - f.src;
             for(size_t i = 0; i < f.len; i++) {
                 dec.push_back(dec[src + i]);
             }
         } else {
-            dec.push_back(f.literal());
+            dec.push_back(typename String::value_type(f.literal()));
         }
     }
     return dec;
 }
 
+// builds a text of at least n characters from suffixes of the given text, each followed by a run of growing length
+inline std::string repetitive_text(std::string const& text, size_t const n) {
+    std::string s;
+    for(size_t i = 0; s.size() < n; i++) {
+        s += text.substr(i % text.size());
+        s.append(i % 300, 'a' + i % 3);
+    }
+    return s;
+}
+
 }
@@ -0,0 +1,142 @@
+/**
+ * test_em.cpp
+ * part of pdinklag/lz77
+ * 
+ * MIT License
+ * 
+ * Copyright (c) Patrick Dinklage
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest.h"
+
+#include <filesystem>
+#include <fstream>
+#include <random>
+
+#include <lz77/em_factorizer.hpp>
+#include <lz77/kkp2_factorizer.hpp>
+#include "decode.hpp"
+
+namespace lz77::test {
+
+TEST_SUITE("em_factorizer") {
+    std::string text = "ananasbananapanamabahamascabana";
+
+    TEST_CASE("EMFactorizer") {
+        auto const input = std::filesystem::temp_directory_path() / "lz77-test-em.txt";
+        {
+            std::ofstream f(input, std::ios::binary);
+            f << text;
+        }
+
+        EMFactorizer em;
+        em.ram_budget(256); // force multiple runs and merge passes
+        std::vector<Factor> factors;
+        factors.reserve(17);
+        auto out = std::back_inserter(factors);
+        em.factorize(input, out);
+        std::filesystem::remove(input);
+
+        CHECK(factors.size() == 17);
+        CHECK(factors[0] == Factor('a'));
+        CHECK(factors[1] == Factor('n'));
+        CHECK(factors[2] == Factor(2, 3));
+        CHECK(factors[3] == Factor('s'));
+        CHECK(factors[4] == Factor('b'));
+        CHECK(factors[5] == Factor(7, 5));
+        CHECK(factors[6] == Factor('p'));
+        CHECK(factors[7] == Factor(6, 3));
+        CHECK(factors[8] == Factor('m'));
+        CHECK(factors[9] == Factor('a'));
+        CHECK(factors[10] == Factor(12, 2));
+        CHECK(factors[11] == Factor('h'));
+        CHECK(factors[12] == Factor(6, 3));
+        CHECK(factors[13] == Factor('s'));
+        CHECK(factors[14] == Factor('c'));
+        CHECK(factors[15] == Factor(9, 3));
+        CHECK(factors[16] == Factor(15, 2));
+        CHECK(em.io_volume().bytes_read > 0);
+        CHECK(em.io_volume().bytes_written > 0);
+
+        auto const dec = decode(factors.begin(), factors.end());
+        CHECK(dec == text);
+    }
+
+    TEST_CASE("EMFactorizer with maximum reference length") {
+        auto const input = std::filesystem::temp_directory_path() / "lz77-test-em-max.txt";
+        std::string const s = text + text + text;
+        {
+            std::ofstream f(input, std::ios::binary);
+            f << s;
+        }
+
+        EMFactorizer em;
+        em.ram_budget(256);
+        em.max_reference_length(5);
+        KKP2Factorizer kkp2;
+        kkp2.max_reference_length(5);
+
+        std::vector<Factor> expected, factors;
+        em.factorize(input, std::back_inserter(factors));
+        kkp2.factorize(s.begin(), s.end(), std::back_inserter(expected));
+        std::filesystem::remove(input);
+
+        CHECK(factors == expected);
+        CHECK(decode(factors.begin(), factors.end()) == s);
+    }
+
+    TEST_CASE("EMFactorizer on a larger random text") {
+        // random symbols interleaved with copies of earlier substrings, so that both literals and long references occur
+        std::mt19937 gen(77);
+        std::string s;
+        while(s.size() < 300'000) {
+            if(s.size() < 1'000 || gen() % 2) {
+                for(size_t i = gen() % 100; i > 0; i--) s.push_back('a' + gen() % 4);
+            } else {
+                size_t const len = gen() % 1'000 + 1;
+                size_t const src = gen() % (s.size() - len);
+                s.append(s, src, len);
+            }
+        }
+
+        auto const input = std::filesystem::temp_directory_path() / "lz77-test-em-random.txt";
+        {
+            std::ofstream f(input, std::ios::binary);
+            f << s;
+        }
+
+        EMFactorizer em;
+        em.ram_budget(1 << 20); // far below the size of the sorted records, forcing runs to be spilled and merged
+        KKP2Factorizer kkp2;
+
+        std::vector<Factor> expected, factors;
+        em.factorize(input, std::back_inserter(factors));
+        kkp2.factorize(s.begin(), s.end(), std::back_inserter(expected));
+        std::filesystem::remove(input);
+
+        CHECK(factors == expected);
+        CHECK(em.io_volume().bytes_written > 10 * s.size());
+        CHECK(decode(factors.begin(), factors.end()) == s);
+    }
+}
+
+}
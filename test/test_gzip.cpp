@@ -28,6 +28,9 @@
 #define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
 #include "doctest.h"
 
+#include <list>
+
+#include <lz77/gzip_factorizer.hpp>
 #include <lz77/gzip9_factorizer.hpp>
 #include "decode.hpp"
 
@@ -69,6 +72,273 @@ TEST_SUITE("gzip_factorizer") {
         auto const dec = decode(factors.begin(), factors.end());
         CHECK(dec == text);
     }
+
+    TEST_CASE("GzipFactorizer levels") {
+        // the fast levels take "abc" and then "def" greedily, the lazy levels defer to "bcdef"
+        std::string const s = "xabcybcdefzabcdefw";
+        std::vector<Factor> fast, lazy;
+        GzipFactorizer<1>().factorize(s.begin(), s.end(), std::back_inserter(fast));
+        GzipFactorizer<4>().factorize(s.begin(), s.end(), std::back_inserter(lazy));
+
+        CHECK(fast.size() == 14);
+        CHECK(fast[11] == Factor(10, 3));
+        CHECK(fast[12] == Factor(7, 3));
+        CHECK(fast[13] == Factor('w'));
+
+        CHECK(lazy.size() == 14);
+        CHECK(lazy[11] == Factor('a'));
+        CHECK(lazy[12] == Factor(7, 5));
+        CHECK(lazy[13] == Factor('w'));
+    }
+
+    template<unsigned level>
+    void check_level(std::string const& s) {
+        GzipFactorizer<level> gzip;
+        std::vector<Factor> factors;
+        gzip.factorize(s.begin(), s.end(), std::back_inserter(factors));
+        CHECK(decode(factors.begin(), factors.end()) == s);
+    }
+
+    TEST_CASE("GzipFactorizer levels on a larger text") {
+        // long runs exceed the maximum insert length of the fast levels, the text exceeds the window
+        std::string const s = repetitive_text(text, 100'000);
+        check_level<1>(s);
+        check_level<2>(s);
+        check_level<3>(s);
+        check_level<4>(s);
+        check_level<5>(s);
+        check_level<6>(s);
+        check_level<7>(s);
+        check_level<8>(s);
+        check_level<9>(s);
+    }
+
+    TEST_CASE("GzipFactorizer with a large window") {
+        // a pseudo-random block repeated at a distance beyond gzip's window
+        std::string block;
+        uint32_t x = 1;
+        for(size_t i = 0; i < 50'000; i++) {
+            x = x * 1103515245 + 12345;
+            block.push_back('a' + (x >> 16) % 26);
+        }
+        std::string const s = block + block;
+
+        std::vector<Factor> small, large;
+        GzipFactorizer<9>().factorize(s.begin(), s.end(), std::back_inserter(small));
+        GzipFactorizer<9, 17>().factorize(s.begin(), s.end(), std::back_inserter(large));
+
+        size_t max_src_small = 0, max_src_large = 0;
+        for(auto const& f : small) if(f.is_reference()) max_src_small = std::max(max_src_small, (size_t)f.src);
+        for(auto const& f : large) if(f.is_reference()) max_src_large = std::max(max_src_large, (size_t)f.src);
+        CHECK(max_src_small < 32'768);
+        CHECK(max_src_large == block.size());
+        CHECK(large.size() < small.size());
+
+        CHECK(decode(small.begin(), small.end()) == s);
+        CHECK(decode(large.begin(), large.end()) == s);
+    }
+
+    TEST_CASE("GzipFactorizer with multiplicative hashing") {
+        std::string const s = repetitive_text(text, 100'000);
+
+        std::vector<Factor> fast, lazy;
+        GzipFactorizer<1, 15, MultiplicativeHash>().factorize(s.begin(), s.end(), std::back_inserter(fast));
+        GzipFactorizer<9, 15, MultiplicativeHash>().factorize(s.begin(), s.end(), std::back_inserter(lazy));
+
+        for(auto const& f : fast) if(f.is_reference()) CHECK(f.len >= 3);
+        for(auto const& f : lazy) if(f.is_reference()) CHECK(f.len >= 3);
+        CHECK(decode(fast.begin(), fast.end()) == s);
+        CHECK(decode(lazy.begin(), lazy.end()) == s);
+    }
+
+    template<typename Gzip>
+    void check_contiguous(std::string const& s) {
+        // the same instance is reused for both inputs
+        Gzip gzip;
+        std::vector<Factor> direct, copied;
+        gzip.factorize(s.begin(), s.end(), std::back_inserter(direct));
+
+        std::list<char> const l(s.begin(), s.end());
+        auto emit = [&](Factor f){ copied.push_back(f); };
+        gzip.factorize(l.begin(), l.end(), emit, emit);
+
+        CHECK(direct == copied);
+        CHECK(decode(direct.begin(), direct.end()) == s);
+    }
+
+    TEST_CASE("GzipFactorizer on contiguous input") {
+        // contiguous input is matched in place, the results must equal those for copied input at every input length around the window borders
+        std::string const s = repetitive_text(text, 66'000);
+        for(size_t n : {0, 1, 2, 3, 4, 100, 65'536 - 300, 65'536 - 8, 65'536 - 1, 65'536, 65'536 + 1, 65'536 + 7, 65'536 + 8, 65'536 + 300}) {
+            std::string const prefix = s.substr(0, n);
+            check_contiguous<GzipFactorizer<1>>(prefix);
+            check_contiguous<GzipFactorizer<9>>(prefix);
+            check_contiguous<GzipFactorizer<9, 15, MultiplicativeHash>>(prefix);
+        }
+    }
+
+    TEST_CASE("GzipFactorizer statistics") {
+        std::string const s = repetitive_text(text, 100'000);
+
+        std::vector<Factor> factors, plain;
+        GzipFactorizer<9, 15, GzipHash, true> gzip;
+        gzip.factorize(s.begin(), s.end(), std::back_inserter(factors));
+        GzipFactorizer<9>().factorize(s.begin(), s.end(), std::back_inserter(plain));
+        CHECK(factors == plain);
+
+        auto const& stats = gzip.stats();
+        CHECK(stats.num_searches > 0);
+        CHECK(stats.max_chain_length <= 4096);
+        CHECK(stats.total_chain_length >= stats.num_searches);
+        CHECK(stats.total_chain_length <= stats.num_searches * stats.max_chain_length);
+        CHECK(stats.bytes_compared > 0);
+        CHECK(stats.nice_matches > 0);
+        CHECK(stats.greedy_skips > 0);
+
+        uintmax_t histogram_sum = 0;
+        for(auto const x : stats.chain_length_histogram) histogram_sum += x;
+        CHECK(histogram_sum == stats.num_searches);
+
+        // statistics are reset for every factorization
+        gzip.factorize(s.begin(), s.end(), [](Factor){}, [](Factor){});
+        CHECK(gzip.stats().num_searches == stats.num_searches);
+    }
+
+    TEST_CASE("GzipFactorizer with a dictionary") {
+        // like in gzip, the very first position is never referenced
+        std::string const s = "x" + text + text;
+        auto const mid = s.begin() + 1 + text.size();
+
+        std::vector<Factor> factors;
+        auto emit = [&](Factor f){ factors.push_back(f); };
+        Gzip9Factorizer gzip9;
+        gzip9.factorize(s.begin(), mid, s.end(), emit, emit);
+
+        // the second copy of the text is a single reference into the dictionary
+        CHECK(factors.size() == 1);
+        CHECK(factors[0] == Factor(text.size(), text.size()));
+
+        // the dictionary is forgotten afterwards
+        factors.clear();
+        gzip9.factorize(mid, s.end(), emit, emit);
+        CHECK(factors[0] == Factor('a'));
+    }
+
+    template<typename Gzip>
+    void check_push(std::string const& s, size_t const chunk_size) {
+        std::vector<Factor> batch, pushed;
+        Gzip().factorize(s.begin(), s.end(), std::back_inserter(batch));
+
+        Gzip gzip;
+        size_t covered = 0;
+        auto emit = [&](Factor f){ pushed.push_back(f); covered += f.is_reference() ? f.len : 1; };
+        gzip.start(emit, emit);
+        for(size_t i = 0; i < s.size(); i += chunk_size) {
+            size_t const j = std::min(i + chunk_size, s.size());
+            gzip.feed(s.begin() + i, s.begin() + j);
+
+            // all but the factors within the lookahead and a pending lazy match are emitted immediately
+            CHECK(covered + 600 >= j);
+        }
+        gzip.finish();
+
+        CHECK(pushed == batch);
+    }
+
+    TEST_CASE("GzipFactorizer with pushed input") {
+        std::string const s = repetitive_text(text, 200'000);
+        for(size_t chunk_size : {1'000, 4'096, 65'536, 100'000, 200'000}) {
+            check_push<GzipFactorizer<1>>(s, chunk_size);
+            check_push<GzipFactorizer<9>>(s, chunk_size);
+        }
+        check_push<GzipFactorizer<6, 16>>(s, 777);
+        check_push<GzipFactorizer<6>>(s.substr(0, 5'000), 1);
+        check_push<GzipFactorizer<6>>(std::string(), 1);
+    }
+
+    template<typename Gzip>
+    void check_flush(std::string const& s, size_t const chunk_size, size_t const max_latency) {
+        std::vector<Factor> factors;
+        size_t covered = 0;
+        auto emit = [&](Factor f){ factors.push_back(f); covered += f.is_reference() ? f.len : 1; };
+
+        Gzip gzip;
+        gzip.max_latency(max_latency);
+        gzip.start(emit, emit);
+        for(size_t i = 0; i < s.size(); i += chunk_size) {
+            size_t const j = std::min(i + chunk_size, s.size());
+            gzip.feed(s.begin() + i, s.begin() + j);
+
+            if(max_latency == SIZE_MAX) {
+                // flush explicitly
+                gzip.flush();
+                CHECK(covered == j);
+            } else {
+                CHECK(covered + max_latency >= j);
+            }
+        }
+        gzip.finish();
+
+        CHECK(covered == s.size());
+        CHECK(decode(factors.begin(), factors.end()) == s);
+    }
+
+    TEST_CASE("GzipFactorizer flush") {
+        std::string const s = repetitive_text(text, 100'000);
+        for(size_t chunk_size : {1, 10, 1'000, 70'000}) {
+            check_flush<GzipFactorizer<1>>(s.substr(0, 20 * chunk_size), chunk_size, SIZE_MAX);
+            check_flush<GzipFactorizer<9>>(s.substr(0, 20 * chunk_size), chunk_size, SIZE_MAX);
+        }
+        for(size_t max_latency : {0, 100, 1'000}) {
+            check_flush<GzipFactorizer<1>>(s, 333, max_latency);
+            check_flush<GzipFactorizer<9>>(s, 333, max_latency);
+        }
+    }
+
+    TEST_CASE("GzipFactorizer keeps the window when flushing") {
+        std::vector<Factor> factors;
+        auto emit = [&](Factor f){ factors.push_back(f); };
+
+        // like in gzip, the very first position is never referenced
+        std::string const first = "x" + text;
+
+        Gzip9Factorizer gzip9;
+        gzip9.start(emit, emit);
+        gzip9.feed(first.begin(), first.end());
+        gzip9.flush();
+        size_t const num_first = factors.size();
+
+        // the second copy of the text references the first one
+        gzip9.feed(text.begin(), text.end());
+        gzip9.finish();
+        CHECK(factors.size() == num_first + 1);
+        CHECK(factors.back() == Factor(text.size(), text.size()));
+    }
+
+    TEST_CASE("common_prefix_length") {
+        // padded so that the kernel may read beyond the maximum
+        std::string a(300, 'x'), b(300, 'x');
+        for(size_t mismatch : {0, 1, 7, 8, 9, 63, 64, 255}) {
+            std::string c = b;
+            c[mismatch] = 'y';
+            for(size_t max : {0, 1, 8, 20, 256}) {
+                size_t const l = internal::common_prefix_length((uint8_t const*)a.data(), (uint8_t const*)c.data(), max);
+                CHECK(l == std::min(mismatch, max));
+            }
+        }
+    }
+
+    TEST_CASE("Gzip9Factorizer with maximum reference length") {
+        std::string const s = text + text + text;
+        Gzip9Factorizer gzip9;
+        gzip9.max_reference_length(4);
+
+        std::vector<Factor> factors;
+        gzip9.factorize(s.begin(), s.end(), std::back_inserter(factors));
+
+        for(auto const& f : factors) CHECK(f.len <= 4);
+        CHECK(decode(factors.begin(), factors.end()) == s);
+    }
 }
 
 }
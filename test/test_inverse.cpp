@@ -0,0 +1,68 @@
+/**
+ * test_lpf.cpp
+ * part of pdinklag/lz77
+ * 
+ * MIT License
+ * 
+ * Copyright (c) Patrick Dinklage
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest.h"
+
+#include <algorithm>
+#include <numeric>
+#include <random>
+#include <vector>
+
+#include <lz77/inverse_suffix_array.hpp>
+
+namespace lz77::test {
+
+TEST_SUITE("inverse_suffix_array") {
+    template<typename Index>
+    void check_inverse(size_t const n) {
+        std::vector<Index> sa(n), isa(n);
+        std::iota(sa.begin(), sa.end(), 0);
+        std::shuffle(sa.begin(), sa.end(), std::mt19937(n));
+
+        Report report;
+        inverse_suffix_array<Index>(sa.data(), isa.data(), n, report);
+
+        bool correct = true;
+        for(size_t i = 0; i < n; i++) correct = correct && (isa[sa[i]] == i);
+        CHECK(correct);
+    }
+
+    TEST_CASE("small") {
+        check_inverse<uint32_t>(0);
+        check_inverse<uint32_t>(1);
+        check_inverse<uint32_t>(1000);
+    }
+
+    TEST_CASE("partitioned") {
+        // large enough to be partitioned, and not a multiple of the bucket size
+        check_inverse<uint32_t>((1ULL << 22) + 12345);
+        check_inverse<uint64_t>((1ULL << 22) + 12345);
+    }
+}
+
+}
@@ -29,6 +29,7 @@
 #include "doctest.h"
 
 #include <lz77/kkp2_factorizer.hpp>
+#include <lz77/naive_factorizer.hpp>
 #include "decode.hpp"
 
 namespace lz77::test {
@@ -38,6 +39,7 @@ TEST_SUITE("kkp2_factorizer") {
 
     TEST_CASE("KKP2Factorizer") {
         KKP2Factorizer lpf;
+        lpf.small_input_threshold(0); // use the suffix array even for the small text
         std::vector<Factor> factors;
         factors.reserve(17);
         auto out = std::back_inserter(factors);
@@ -65,6 +67,130 @@ TEST_SUITE("kkp2_factorizer") {
         auto const dec = decode(factors.begin(), factors.end());
         CHECK(dec == text);
     }
+
+    TEST_CASE("KKP2Factorizer with integer symbols") {
+        // 32-bit symbols exceed the text length, forcing an alphabet reduction
+        std::u16string const text16(text.begin(), text.end());
+        std::vector<uint32_t> text32;
+        for(char const c : text) text32.push_back(uint32_t(c) << 20);
+
+        KKP2Factorizer lpf;
+        lpf.small_input_threshold(0); // use the suffix array even for the small text
+        std::vector<Factor> expected, factors16, factors32;
+        lpf.factorize(text.begin(), text.end(), std::back_inserter(expected));
+        lpf.factorize(text16.begin(), text16.end(), std::back_inserter(factors16));
+        lpf.factorize(text32.begin(), text32.end(), std::back_inserter(factors32));
+
+        CHECK(factors16 == expected);
+        REQUIRE(factors32.size() == expected.size());
+        for(size_t i = 0; i < expected.size(); i++) {
+            CHECK(factors32[i] == (expected[i].is_literal() ? Factor(uint32_t(expected[i].literal()) << 20) : expected[i]));
+        }
+
+        CHECK(decode<std::u16string>(factors16.begin(), factors16.end()) == text16);
+        CHECK(decode<std::vector<uint32_t>>(factors32.begin(), factors32.end()) == text32);
+    }
+
+    TEST_CASE("KKP2Factorizer with allocation policy") {
+        // huge pages may not be available, but the result must not depend on it
+        KKP2Factorizer lpf;
+        lpf.small_input_threshold(0); // use the suffix array even for the small text
+        std::vector<Factor> expected, factors;
+        lpf.factorize(text.begin(), text.end(), std::back_inserter(expected));
+
+        lpf.allocation_policy({AllocationPolicy::HugePages::transparent, true, true});
+        lpf.factorize(text.begin(), text.end(), std::back_inserter(factors));
+        CHECK(factors == expected);
+
+        factors.clear();
+        lpf.allocation_policy({AllocationPolicy::HugePages::hugetlb, false, false});
+        lpf.factorize(text.begin(), text.end(), std::back_inserter(factors));
+        CHECK(factors == expected);
+    }
+    TEST_CASE("KKP2Factorizer with maximum distance") {
+        for(size_t const max_dist : {0, 1, 4, 12}) {
+            KKP2Factorizer lpf;
+            lpf.small_input_threshold(0); // use the suffix array even for the small text
+            lpf.max_distance(max_dist);
+            NaiveFactorizer naive;
+            naive.max_distance(max_dist);
+
+            std::vector<Factor> expected, factors;
+            naive.factorize(text.begin(), text.end(), std::back_inserter(expected));
+            lpf.factorize(text.begin(), text.end(), std::back_inserter(factors));
+            CHECK(factors == expected);
+
+            for(auto const& f : factors) {
+                if(f.is_reference()) CHECK(f.src <= max_dist);
+            }
+            CHECK(decode(factors.begin(), factors.end()) == text);
+        }
+    }
+    TEST_CASE("KKP2Factorizer with maximum reference length") {
+        std::string const s = text + text + text;
+        for(size_t const max_ref_len : {2, 3, 10}) {
+            KKP2Factorizer lpf;
+            lpf.small_input_threshold(0); // use the suffix array even for the small text
+            lpf.max_reference_length(max_ref_len);
+            NaiveFactorizer naive;
+            naive.max_reference_length(max_ref_len);
+
+            std::vector<Factor> expected, factors;
+            naive.factorize(s.begin(), s.end(), std::back_inserter(expected));
+            lpf.factorize(s.begin(), s.end(), std::back_inserter(factors));
+            CHECK(factors == expected);
+
+            for(auto const& f : factors) CHECK(f.len <= max_ref_len);
+            CHECK(decode(factors.begin(), factors.end()) == s);
+        }
+    }
+
+    TEST_CASE("KKP2Factorizer without overlaps") {
+        std::string const s = text + std::string(100, 'a') + text;
+        for(size_t const max_dist : {size_t(4), SIZE_MAX}) {
+            KKP2Factorizer lpf;
+            lpf.small_input_threshold(0); // use the suffix array even for the small text
+            lpf.non_overlapping(true);
+            lpf.max_distance(max_dist);
+            NaiveFactorizer naive;
+            naive.non_overlapping(true);
+            naive.max_distance(max_dist);
+
+            std::vector<Factor> expected, factors;
+            naive.factorize(s.begin(), s.end(), std::back_inserter(expected));
+            lpf.factorize(s.begin(), s.end(), std::back_inserter(factors));
+            CHECK(factors == expected);
+
+            for(auto const& f : factors) CHECK(f.len <= f.src);
+            CHECK(decode(factors.begin(), factors.end()) == s);
+        }
+    }
+
+    TEST_CASE("KKP2Factorizer without overlaps on periodic texts") {
+        // periodic texts are the worst case for the suffix array walks, as the LCP with most suffixes stays large
+        std::string growing_runs;
+        for(size_t k = 1; growing_runs.size() < 2'000; k++) {
+            growing_runs.append(k, 'a');
+            growing_runs += 'b';
+        }
+
+        std::string alternating;
+        while(alternating.size() < 2'000) alternating += "ab";
+
+        for(auto const& s : {std::string(2'000, 'a'), std::string(1'999, 'a') + 'b', alternating, growing_runs}) {
+            KKP2Factorizer lpf;
+            lpf.small_input_threshold(0);
+            lpf.non_overlapping(true);
+            NaiveFactorizer naive;
+            naive.non_overlapping(true);
+
+            std::vector<Factor> expected, factors;
+            naive.factorize(s.begin(), s.end(), std::back_inserter(expected));
+            lpf.factorize(s.begin(), s.end(), std::back_inserter(factors));
+            CHECK(factors == expected);
+            CHECK(decode(factors.begin(), factors.end()) == s);
+        }
+    }
 }
 
 }
@@ -28,7 +28,9 @@
 #define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
 #include "doctest.h"
 
+#include <lz77/lpf_array.hpp>
 #include <lz77/lpf_factorizer.hpp>
+#include <lz77/naive_factorizer.hpp>
 #include "decode.hpp"
 
 namespace lz77::test {
@@ -36,8 +38,15 @@ namespace lz77::test {
 TEST_SUITE("lpf_factorizer") {
     std::string text = "ananasbananapanamabahamascabana";
 
-    TEST_CASE("LPFFactorizer") {
+    // the test texts are below the small input threshold, but shall be factorized using the suffix array
+    LPFFactorizer suffix_array_lpf() {
         LPFFactorizer lpf;
+        lpf.small_input_threshold(0);
+        return lpf;
+    }
+
+    TEST_CASE("LPFFactorizer") {
+        LPFFactorizer lpf = suffix_array_lpf();
         std::vector<Factor> factors;
         factors.reserve(17);
         auto out = std::back_inserter(factors);
@@ -65,6 +74,212 @@ TEST_SUITE("lpf_factorizer") {
         auto const dec = decode(factors.begin(), factors.end());
         CHECK(dec == text);
     }
+
+    TEST_CASE("LPFFactorizer with integer symbols") {
+        // 32-bit symbols exceed the text length, forcing an alphabet reduction
+        std::u16string const text16(text.begin(), text.end());
+        std::vector<uint32_t> text32;
+        for(char const c : text) text32.push_back(uint32_t(c) << 20);
+
+        LPFFactorizer lpf = suffix_array_lpf();
+        std::vector<Factor> expected, factors16, factors32;
+        lpf.factorize(text.begin(), text.end(), std::back_inserter(expected));
+        lpf.factorize(text16.begin(), text16.end(), std::back_inserter(factors16));
+        lpf.factorize(text32.begin(), text32.end(), std::back_inserter(factors32));
+
+        CHECK(factors16 == expected);
+        REQUIRE(factors32.size() == expected.size());
+        for(size_t i = 0; i < expected.size(); i++) {
+            CHECK(factors32[i] == (expected[i].is_literal() ? Factor(uint32_t(expected[i].literal()) << 20) : expected[i]));
+        }
+
+        CHECK(decode<std::u16string>(factors16.begin(), factors16.end()) == text16);
+        CHECK(decode<std::vector<uint32_t>>(factors32.begin(), factors32.end()) == text32);
+    }
+
+    TEST_CASE("LPFFactorizer with allocation policy") {
+        // huge pages may not be available, but the result must not depend on it
+        LPFFactorizer lpf = suffix_array_lpf();
+        std::vector<Factor> expected, factors;
+        lpf.factorize(text.begin(), text.end(), std::back_inserter(expected));
+
+        lpf.allocation_policy({AllocationPolicy::HugePages::transparent, true, true});
+        lpf.factorize(text.begin(), text.end(), std::back_inserter(factors));
+        CHECK(factors == expected);
+
+        factors.clear();
+        lpf.allocation_policy({AllocationPolicy::HugePages::hugetlb, false, false});
+        lpf.factorize(text.begin(), text.end(), std::back_inserter(factors));
+        CHECK(factors == expected);
+    }
+
+    TEST_CASE("LPFFactorizer with maximum distance") {
+        for(size_t const max_dist : {0, 1, 4, 12}) {
+            LPFFactorizer lpf = suffix_array_lpf();
+            lpf.max_distance(max_dist);
+            NaiveFactorizer naive;
+            naive.max_distance(max_dist);
+
+            std::vector<Factor> expected, factors;
+            naive.factorize(text.begin(), text.end(), std::back_inserter(expected));
+            lpf.factorize(text.begin(), text.end(), std::back_inserter(factors));
+            CHECK(factors == expected);
+
+            for(auto const& f : factors) {
+                if(f.is_reference()) CHECK(f.src <= max_dist);
+            }
+            CHECK(decode(factors.begin(), factors.end()) == text);
+        }
+    }
+
+    TEST_CASE("LPFFactorizer with maximum reference length") {
+        std::string const s = text + text + text;
+        for(size_t const max_ref_len : {2, 3, 10}) {
+            LPFFactorizer lpf = suffix_array_lpf();
+            lpf.max_reference_length(max_ref_len);
+            NaiveFactorizer naive;
+            naive.max_reference_length(max_ref_len);
+
+            std::vector<Factor> expected, factors;
+            naive.factorize(s.begin(), s.end(), std::back_inserter(expected));
+            lpf.factorize(s.begin(), s.end(), std::back_inserter(factors));
+            CHECK(factors == expected);
+
+            for(auto const& f : factors) CHECK(f.len <= max_ref_len);
+            CHECK(decode(factors.begin(), factors.end()) == s);
+        }
+    }
+
+    TEST_CASE("LPFFactorizer without overlaps") {
+        std::string const s = text + std::string(100, 'a') + text;
+        for(size_t const max_dist : {size_t(4), SIZE_MAX}) {
+            LPFFactorizer lpf = suffix_array_lpf();
+            lpf.non_overlapping(true);
+            lpf.max_distance(max_dist);
+            NaiveFactorizer naive;
+            naive.non_overlapping(true);
+            naive.max_distance(max_dist);
+
+            std::vector<Factor> expected, factors;
+            naive.factorize(s.begin(), s.end(), std::back_inserter(expected));
+            lpf.factorize(s.begin(), s.end(), std::back_inserter(factors));
+            CHECK(factors == expected);
+
+            for(auto const& f : factors) CHECK(f.len <= f.src);
+            CHECK(decode(factors.begin(), factors.end()) == s);
+        }
+    }
+
+    template<typename Entry>
+    void check_lpf_array() {
+        size_t const n = text.size();
+        std::vector<Entry> lpf(n), prev_occ(n);
+        lpf_array(text.begin(), text.end(), lpf.data(), prev_occ.data());
+
+        for(size_t i = 0; i < n; i++) {
+            // compute longest previous factor naively
+            size_t max_lcp = 0;
+            for(size_t j = 0; j < i; j++) {
+                size_t l = 0;
+                while(i + l < n && text[i + l] == text[j + l]) ++l;
+                max_lcp = std::max(max_lcp, l);
+            }
+            CHECK(uint64_t(lpf[i]) == max_lcp);
+
+            if(max_lcp > 0) {
+                size_t const src = prev_occ[i];
+                CHECK(src < i);
+                CHECK(text.compare(src, max_lcp, text, i, max_lcp) == 0);
+            }
+        }
+    }
+
+    TEST_CASE("LPFFactorizer with lazy evaluation") {
+        std::string const s = "xabcybcdefzabcdefw";
+        std::vector<Factor> greedy, lazy;
+        {
+            LPFFactorizer lpf;
+            lpf.factorize(s.begin(), s.end(), std::back_inserter(greedy));
+        }
+        {
+            LPFFactorizer lpf;
+            lpf.lazy_match_length(SIZE_MAX);
+            lpf.factorize(s.begin(), s.end(), std::back_inserter(lazy));
+        }
+
+        // greedy takes "abc" and then "def", lazy defers to "bcdef"
+        CHECK(greedy.size() == 13);
+        CHECK(greedy[10] == Factor(10, 3));
+        CHECK(greedy[11] == Factor(7, 3));
+        CHECK(lazy.size() == 13);
+        CHECK(lazy[10] == Factor('a'));
+        CHECK(lazy[11] == Factor(7, 5));
+        CHECK(decode(lazy.begin(), lazy.end()) == s);
+
+        // matches not shorter than the lazy match length are taken greedily
+        std::vector<Factor> factors;
+        LPFFactorizer lpf;
+        lpf.lazy_match_length(3);
+        lpf.factorize(s.begin(), s.end(), std::back_inserter(factors));
+        CHECK(factors == greedy);
+    }
+
+    TEST_CASE("LPFFactorizer with lazy evaluation on a larger text") {
+        std::string s;
+        for(size_t i = 0; i < 1000; i++) s.push_back('a' + (i * i + i / 7) % 5);
+
+        LPFFactorizer lpf;
+        lpf.lazy_match_length(SIZE_MAX);
+        std::vector<Factor> factors;
+        lpf.factorize(s.begin(), s.end(), std::back_inserter(factors));
+
+        // simulate lazy evaluation on the brute-force longest previous factors
+        auto longest_previous_factor = [&](size_t const i){
+            size_t max = 0;
+            for(size_t j = 0; j < i; j++) {
+                size_t l = 0;
+                while(i + l < s.size() && s[i + l] == s[j + l]) ++l;
+                max = std::max(max, l);
+            }
+            return max;
+        };
+
+        size_t i = 0;
+        for(auto const& f : factors) {
+            size_t const l = longest_previous_factor(i);
+            if(l >= lpf.min_reference_length() && (i + 1 == s.size() || longest_previous_factor(i + 1) <= l)) {
+                CHECK(f.len == l);
+                i += l;
+            } else {
+                CHECK(f.is_literal());
+                ++i;
+            }
+        }
+        CHECK(decode(factors.begin(), factors.end()) == s);
+    }
+
+    TEST_CASE("lpf_array") {
+        check_lpf_array<uint32_t>();
+        check_lpf_array<uint40_t>();
+        check_lpf_array<uint64_t>();
+    }
+
+    TEST_CASE("lpf_array in parallel blocks") {
+        std::string s;
+        for(size_t i = 0; i < 1000; i++) s.push_back('a' + (i * i + i / 7) % 3);
+        std::span<char const> const t(s.data(), s.size());
+
+        Report report;
+        std::vector<uint32_t> expected_lpf(s.size()), expected_prev_occ(s.size());
+        internal::lpf_array<uint32_t>(t, expected_lpf.data(), expected_prev_occ.data(), report, AllocationPolicy(), 1, UINT32_MAX);
+
+        for(size_t const num_blocks : {2, 3, 8, 100}) {
+            std::vector<uint32_t> lpf(s.size()), prev_occ(s.size());
+            internal::lpf_array<uint32_t>(t, lpf.data(), prev_occ.data(), report, AllocationPolicy(), num_blocks, UINT32_MAX);
+            CHECK(lpf == expected_lpf);
+            CHECK(prev_occ == expected_prev_occ);
+        }
+    }
 }
 
 }
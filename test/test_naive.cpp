@@ -0,0 +1,184 @@
+/**
+ * test_naive.cpp
+ * part of pdinklag/lz77
+ * 
+ * MIT License
+ * 
+ * Copyright (c) Patrick Dinklage
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest.h"
+
+#include <lz77/kkp2_factorizer.hpp>
+#include <lz77/lpf_factorizer.hpp>
+#include <lz77/naive_factorizer.hpp>
+#include "decode.hpp"
+
+namespace lz77::test {
+
+TEST_SUITE("naive_factorizer") {
+    std::string text = "ananasbananapanamabahamascabana";
+
+    TEST_CASE("NaiveFactorizer") {
+        NaiveFactorizer naive;
+        std::vector<Factor> factors;
+        factors.reserve(17);
+        auto out = std::back_inserter(factors);
+        naive.factorize(text.begin(), text.end(), out);
+
+        CHECK(factors.size() == 17);
+        CHECK(factors[0] == Factor('a'));
+        CHECK(factors[1] == Factor('n'));
+        CHECK(factors[2] == Factor(2, 3));
+        CHECK(factors[3] == Factor('s'));
+        CHECK(factors[4] == Factor('b'));
+        CHECK(factors[5] == Factor(7, 5));
+        CHECK(factors[6] == Factor('p'));
+        CHECK(factors[7] == Factor(6, 3));
+        CHECK(factors[8] == Factor('m'));
+        CHECK(factors[9] == Factor('a'));
+        CHECK(factors[10] == Factor(12, 2));
+        CHECK(factors[11] == Factor('h'));
+        CHECK(factors[12] == Factor(6, 3));
+        CHECK(factors[13] == Factor('s'));
+        CHECK(factors[14] == Factor('c'));
+        CHECK(factors[15] == Factor(9, 3));
+        CHECK(factors[16] == Factor(15, 2));
+
+        auto const dec = decode(factors.begin(), factors.end());
+        CHECK(dec == text);
+    }
+
+    TEST_CASE("Small input threshold") {
+        // the fast path must produce exactly the factorization of the suffix array based factorizers
+        std::string s;
+        for(size_t i = 0; i < 200; i++) s.push_back('a' + (i * i + i / 7) % 5);
+
+        for(size_t const min_ref_len : {1, 2, 5}) {
+            KKP2Factorizer kkp2;
+            LPFFactorizer lpf;
+            kkp2.min_reference_length(min_ref_len);
+            lpf.min_reference_length(min_ref_len);
+
+            std::vector<Factor> expected, factors_kkp2, factors_lpf;
+            kkp2.small_input_threshold(0);
+            kkp2.factorize(s.begin(), s.end(), std::back_inserter(expected));
+
+            kkp2.small_input_threshold(s.size());
+            lpf.small_input_threshold(s.size());
+            kkp2.factorize(s.begin(), s.end(), std::back_inserter(factors_kkp2));
+            lpf.factorize(s.begin(), s.end(), std::back_inserter(factors_lpf));
+
+            CHECK(factors_kkp2 == expected);
+            CHECK(factors_lpf == expected);
+            CHECK(decode(expected.begin(), expected.end()) == s);
+        }
+    }
+
+    template<typename String>
+    void check_small_input_threshold(String const& s) {
+        KKP2Factorizer kkp2;
+        LPFFactorizer lpf;
+
+        std::vector<Factor> expected, factors_kkp2, factors_lpf;
+        kkp2.small_input_threshold(0);
+        kkp2.factorize(s.begin(), s.end(), std::back_inserter(expected));
+
+        kkp2.small_input_threshold(s.size());
+        lpf.small_input_threshold(s.size());
+        kkp2.factorize(s.begin(), s.end(), std::back_inserter(factors_kkp2));
+        lpf.factorize(s.begin(), s.end(), std::back_inserter(factors_lpf));
+
+        CHECK(factors_kkp2 == expected);
+        CHECK(factors_lpf == expected);
+        CHECK(decode<String>(expected.begin(), expected.end()) == s);
+    }
+
+    TEST_CASE("Small input threshold with negative symbols") {
+        // symbols are ranked as unsigned values by the suffix array, so the naive path must compare them the same way
+        check_small_input_threshold(std::string("aaa\xff" "aa"));
+        check_small_input_threshold(std::string("\x80" "a\x80\xff" "a\x80" "a\x7f\x80" "a"));
+        check_small_input_threshold(std::basic_string<int16_t>({5, 5, -1, 5, 5, 3, -1, 5, -32768, 5, 5}));
+        check_small_input_threshold(std::basic_string<int32_t>({5, 5, -1, 5, 5, 3, -1, 5, INT32_MIN, 5, 5}));
+    }
+
+    TEST_CASE("NaiveFactorizer with maximum distance") {
+        for(size_t const max_dist : {0, 1, 4, 12}) {
+            NaiveFactorizer naive;
+            naive.max_distance(max_dist);
+            std::vector<Factor> factors;
+            naive.factorize(text.begin(), text.end(), std::back_inserter(factors));
+
+            // each factor must be the longest match within the window
+            size_t i = 0;
+            for(auto const& f : factors) {
+                size_t max_lcp = 0;
+                for(size_t j = (i > max_dist) ? i - max_dist : 0; j < i; j++) {
+                    size_t l = 0;
+                    while(i + l < text.size() && text[i + l] == text[j + l]) ++l;
+                    max_lcp = std::max(max_lcp, l);
+                }
+
+                if(f.is_reference()) {
+                    CHECK(f.src <= max_dist);
+                    CHECK(f.len == max_lcp);
+                    i += f.len;
+                } else {
+                    CHECK(max_lcp < naive.min_reference_length());
+                    ++i;
+                }
+            }
+            CHECK(decode(factors.begin(), factors.end()) == text);
+        }
+    }
+
+    TEST_CASE("NaiveFactorizer without overlaps") {
+        std::string const s = text + std::string(100, 'a');
+        NaiveFactorizer naive;
+        naive.non_overlapping(true);
+        std::vector<Factor> factors;
+        naive.factorize(s.begin(), s.end(), std::back_inserter(factors));
+
+        // each factor must be the longest match that ends before it begins
+        size_t i = 0;
+        for(auto const& f : factors) {
+            size_t max_len = 0;
+            for(size_t j = 0; j < i; j++) {
+                size_t l = 0;
+                while(i + l < s.size() && l < i - j && s[i + l] == s[j + l]) ++l;
+                max_len = std::max(max_len, l);
+            }
+
+            if(f.is_reference()) {
+                CHECK(f.len <= f.src);
+                CHECK(f.len == max_len);
+                i += f.len;
+            } else {
+                CHECK(max_len < naive.min_reference_length());
+                ++i;
+            }
+        }
+        CHECK(decode(factors.begin(), factors.end()) == s);
+    }
+}
+
+}
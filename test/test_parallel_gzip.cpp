@@ -0,0 +1,97 @@
+/**
+ * test_parallel_gzip.cpp
+ * part of pdinklag/lz77
+ * 
+ * MIT License
+ * 
+ * Copyright (c) Patrick Dinklage
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest.h"
+
+#include <lz77/gzip_factorizer.hpp>
+#include <lz77/parallel_gzip_factorizer.hpp>
+#include "decode.hpp"
+
+namespace lz77::test {
+
+TEST_SUITE("parallel_gzip_factorizer") {
+    std::string text = "ananasbananapanamabahamascabana";
+
+    template<unsigned level>
+    void check_blocks(std::string const& s, size_t const block_size) {
+        ParallelGzipFactorizer<level> gzip;
+        gzip.block_size(block_size);
+
+        std::vector<Factor> factors;
+        gzip.factorize(s.begin(), s.end(), std::back_inserter(factors));
+        CHECK(decode(factors.begin(), factors.end()) == s);
+    }
+
+    TEST_CASE("ParallelGzipFactorizer") {
+        std::string const s = repetitive_text(text, 300'000);
+        for(size_t block_size : {1, 100, 4'096, 32'768, 128 * 1024}) {
+            check_blocks<1>(s, block_size);
+            check_blocks<9>(s, block_size);
+        }
+    }
+
+    TEST_CASE("ParallelGzipFactorizer with a single block") {
+        // a single block is factorized exactly like gzip does
+        std::string const s = repetitive_text(text, 100'000);
+
+        std::vector<Factor> parallel, sequential;
+        ParallelGzipFactorizer<6> gzip;
+        gzip.block_size(s.size());
+        gzip.factorize(s.begin(), s.end(), std::back_inserter(parallel));
+        GzipFactorizer<6>().factorize(s.begin(), s.end(), std::back_inserter(sequential));
+        CHECK(parallel == sequential);
+    }
+
+    TEST_CASE("ParallelGzipFactorizer primes blocks with a dictionary") {
+        // each block repeats the previous one, so all blocks start with a reference into the preceding block
+        // except for the first, and for the second, because like in gzip the very first position is never referenced
+        std::string const block = repetitive_text(text, 1'000).substr(0, 1'000);
+
+        std::string s;
+        for(size_t i = 0; i < 10; i++) s += block;
+
+        ParallelGzipFactorizer<9> gzip;
+        gzip.block_size(block.size());
+        std::vector<Factor> factors;
+        gzip.factorize(s.begin(), s.end(), std::back_inserter(factors));
+
+        size_t num_blocks = 0, pos = 0;
+        for(auto const& f : factors) {
+            if(pos % block.size() == 0 && pos > block.size()) {
+                CHECK(f.is_reference());
+                ++num_blocks;
+            }
+            pos += f.is_reference() ? f.len : 1;
+        }
+        CHECK(num_blocks == 8);
+        CHECK(decode(factors.begin(), factors.end()) == s);
+    }
+}
+
+}
@@ -0,0 +1,98 @@
+/**
+ * test_report.cpp
+ * part of pdinklag/lz77
+ * 
+ * MIT License
+ * 
+ * Copyright (c) Patrick Dinklage
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest.h"
+
+#include <lz77/gzip9_factorizer.hpp>
+#include <lz77/kkp2_factorizer.hpp>
+#include <lz77/lpf_factorizer.hpp>
+#include <lz77/sparse_factorizer.hpp>
+#include "decode.hpp"
+
+namespace lz77::test {
+
+TEST_SUITE("report") {
+    std::string text = "ananasbananapanamabahamascabana";
+
+    TEST_CASE("KKP2Factorizer") {
+        KKP2Factorizer kkp2;
+        kkp2.small_input_threshold(0); // use the suffix array even for the small text
+        std::vector<Factor> factors;
+        kkp2.factorize(text.begin(), text.end(), std::back_inserter(factors));
+
+        auto const& report = kkp2.report();
+        CHECK(report.suffix_array.peak_bytes >= text.size() * sizeof(uint32_t));
+        CHECK(report.inverse.peak_bytes > report.suffix_array.peak_bytes);
+        CHECK(report.factorization.peak_bytes > 0);
+        CHECK(report.slide.nanoseconds == 0);
+        CHECK(report.lce_comparisons > 0);
+        CHECK(report.num_threads >= 1);
+    }
+
+    TEST_CASE("LPFFactorizer") {
+        LPFFactorizer lpf;
+        lpf.small_input_threshold(0); // use the suffix array even for the small text
+        std::vector<Factor> factors;
+        lpf.factorize(text.begin(), text.end(), std::back_inserter(factors));
+
+        auto const& report = lpf.report();
+        CHECK(report.suffix_array.peak_bytes == 3 * text.size() * sizeof(uint32_t));
+        CHECK(report.inverse.peak_bytes == 3 * text.size() * sizeof(uint32_t));
+        CHECK(report.factorization.peak_bytes == 2 * text.size() * sizeof(uint32_t));
+        CHECK(report.lce_comparisons == 0); // lengths are taken from the LCP array
+    }
+
+    TEST_CASE("Gzip9Factorizer") {
+        Gzip9Factorizer gzip9;
+        std::vector<Factor> factors;
+        gzip9.factorize(text.begin(), text.end(), std::back_inserter(factors));
+
+        auto const& report = gzip9.report();
+        CHECK(report.suffix_array.peak_bytes == 0);
+        CHECK(report.factorization.peak_bytes > 0);
+        CHECK(report.factorization.nanoseconds > 0);
+        CHECK(report.lce_comparisons > 0);
+        CHECK(report.num_threads == 1);
+    }
+
+    TEST_CASE("SparseFactorizer on low-entropy texts") {
+        // the rank search must neither compare a sampled suffix with itself nor recount characters known to match
+        auto check = [](std::string const& s, uintmax_t const max_comparisons_per_char){
+            SparseFactorizer sparse;
+            std::vector<Factor> factors;
+            sparse.factorize(s.begin(), s.end(), std::back_inserter(factors));
+            CHECK(decode(factors.begin(), factors.end()) == s);
+            CHECK(sparse.report().lce_comparisons < max_comparisons_per_char * s.size());
+        };
+
+        check(std::string(1 << 20, 'a'), 1'000);
+        check(repetitive_text(text, 1 << 20), 100);
+    }
+}
+
+}
@@ -0,0 +1,138 @@
+/**
+ * test_sparse.cpp
+ * part of pdinklag/lz77
+ * 
+ * MIT License
+ * 
+ * Copyright (c) Patrick Dinklage
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest.h"
+
+#include <lz77/naive_factorizer.hpp>
+#include <lz77/sparse_factorizer.hpp>
+#include "decode.hpp"
+
+namespace lz77::test {
+
+TEST_SUITE("sparse_factorizer") {
+    // a text with long repetitions, some of them slightly modified
+    std::string make_text() {
+        std::string s;
+        for(size_t i = 0; i < 300; i++) s.push_back('a' + (i * i + i / 7) % 5);
+        for(size_t r = 0; r < 4; r++) {
+            std::string block = s.substr(r * 37, 120);
+            block[r * 29] = 'z';
+            s += block;
+        }
+        return s;
+    }
+
+    // the factor lengths must equal those of the exact greedy factorization
+    void check_lengths(std::string const& s, std::vector<Factor> const& expected, std::vector<Factor> const& factors) {
+        CHECK(factors.size() == expected.size());
+        for(size_t i = 0; i < std::min(factors.size(), expected.size()); i++) {
+            CHECK(factors[i].len == expected[i].len);
+        }
+        CHECK(decode(factors.begin(), factors.end()) == s);
+    }
+
+    TEST_CASE("SparseFactorizer") {
+        std::string const s = make_text();
+        for(size_t const min_ref_len : {1, 2, 5, 16, 32}) {
+            SparseFactorizer sparse;
+            sparse.min_reference_length(min_ref_len);
+            NaiveFactorizer naive;
+            naive.min_reference_length(min_ref_len);
+
+            std::vector<Factor> expected, factors;
+            naive.factorize(s.begin(), s.end(), std::back_inserter(expected));
+            sparse.factorize(s.begin(), s.end(), std::back_inserter(factors));
+            check_lengths(s, expected, factors);
+        }
+    }
+
+    TEST_CASE("SparseFactorizer with integer symbols") {
+        std::string const s = make_text();
+        std::vector<uint32_t> const t(s.begin(), s.end());
+
+        SparseFactorizer sparse;
+        sparse.min_reference_length(8);
+        NaiveFactorizer naive;
+        naive.min_reference_length(8);
+
+        std::vector<Factor> expected, factors;
+        naive.factorize(t.begin(), t.end(), std::back_inserter(expected));
+        sparse.factorize(t.begin(), t.end(), std::back_inserter(factors));
+        check_lengths(s, expected, factors);
+    }
+
+    TEST_CASE("SparseFactorizer with the maximum symbol") {
+        // the fingerprint of the maximum symbol must not wrap around when it is rolled out
+        std::vector<uint32_t> t = {5, 5, 7, 5, 2147483648, 4294967295, 2147483648};
+        for(size_t i = 0; i < 200; i++) t.push_back((i * i + i / 7) % 5 == 0 ? UINT32_MAX : UINT32_MAX - (i * i + i / 7) % 5);
+
+        for(size_t const min_ref_len : {1, 2, 5}) {
+            SparseFactorizer sparse;
+            sparse.min_reference_length(min_ref_len);
+            NaiveFactorizer naive;
+            naive.min_reference_length(min_ref_len);
+
+            std::vector<Factor> expected, factors;
+            naive.factorize(t.begin(), t.end(), std::back_inserter(expected));
+            sparse.factorize(t.begin(), t.end(), std::back_inserter(factors));
+
+            CHECK(factors.size() == expected.size());
+            for(size_t i = 0; i < std::min(factors.size(), expected.size()); i++) {
+                CHECK(factors[i].len == expected[i].len);
+            }
+            CHECK(decode<std::basic_string<uint32_t>>(factors.begin(), factors.end()) == std::basic_string<uint32_t>(t.begin(), t.end()));
+        }
+    }
+
+    TEST_CASE("SparseFactorizer with maximum distance and reference length") {
+        std::string const s = make_text();
+
+        SparseFactorizer sparse;
+        sparse.min_reference_length(8);
+        sparse.max_distance(100);
+        sparse.max_reference_length(20);
+        NaiveFactorizer naive;
+        naive.min_reference_length(8);
+        naive.max_distance(100);
+        naive.max_reference_length(20);
+
+        std::vector<Factor> expected, factors;
+        naive.factorize(s.begin(), s.end(), std::back_inserter(expected));
+        sparse.factorize(s.begin(), s.end(), std::back_inserter(factors));
+        check_lengths(s, expected, factors);
+
+        for(auto const& f : factors) {
+            if(f.is_reference()) {
+                CHECK(f.src <= 100);
+                CHECK(f.len <= 20);
+            }
+        }
+    }
+}
+
+}